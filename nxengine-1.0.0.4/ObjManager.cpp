@@ -1,6 +1,7 @@
 
 #include "nx.h"
 #include "common/llist.h"
+#include "ai/IrregularBBox.h"
 #include "ObjManager.h"
 #include "ObjManager.fdh"
 
@@ -9,6 +10,7 @@ static Player ZERO_PLAYER;
 
 Object *firstobject = NULL, *lastobject = NULL;
 Object *lowestobject = NULL, *highestobject = NULL;
+Object *firstaftermove = NULL, *lastaftermove = NULL;
 
 /*
 void c------------------------------() {}
@@ -32,6 +34,14 @@ Object *o;
 		o = (Object *)p;
 	}
 	
+	o->geom.sprite = -1;
+	o->geom.center_sprite = -1;
+	
+	// add into list. this is done before SetType so that it can
+	// put us onto the aftermove list at the correct position.
+	LL_ADD_END(o, prev, next, firstobject, lastobject);
+	LL_ADD_END(o, lower, higher, lowestobject, highestobject);
+	
 	// initialize
 	o->SetType(type);
 	o->flags = objprop[type].defaultflags;
@@ -44,10 +54,6 @@ Object *o;
 	o->yinertia = yinertia;
 	o->linkedobject = linkedobject;
 	
-	// add into list
-	LL_ADD_END(o, prev, next, firstobject, lastobject);
-	LL_ADD_END(o, lower, higher, lowestobject, highestobject);
-	
 	// set it's initial blocked states, but do not update blockedstates on objects starting
 	// with nullsprite-- the reason is for objects whose sprite is set after being spawned
 	if (o->sprite != SPR_NULL)
@@ -74,6 +80,13 @@ void Objects::UpdateBlockStates(void)
 	Object *o = firstobject;
 	while(o)
 	{
+		// triggers don't care what's around them
+		if (IsStaticTrigger(o))
+		{
+			o = o->next;
+			continue;
+		}
+		
 		o->lastblockl = o->blockl;
 		o->lastblockr = o->blockr;
 		o->lastblocku = o->blocku;
@@ -87,25 +100,28 @@ void Objects::UpdateBlockStates(void)
 // returns true if the bounding boxes of the two given objects are touching
 bool hitdetect(Object *o1, Object *o2)
 {
-SIFSprite *s1, *s2;
 int32_t rect1x1, rect1y1, rect1x2, rect1y2;
 int32_t rect2x1, rect2y1, rect2x2, rect2y2;
 	
-	// get the sprites used by the two objects
-	s1 = o1->Sprite();
-	s2 = o2->Sprite();
+	if (shadow_enabled)
+	{
+		shadow_boxes("hitdetect", o1, &sprites[o1->sprite].bbox, \
+					o1->Left(), o1->Top(), o1->Right(), o1->Bottom());
+		shadow_boxes("hitdetect", o2, &sprites[o2->sprite].bbox, \
+					o2->Left(), o2->Top(), o2->Right(), o2->Bottom());
+	}
 	
 	// get the bounding rectangle of the first object
-	rect1x1 = o1->x + (s1->bbox.x1 << CSF);
-	rect1x2 = o1->x + (s1->bbox.x2 << CSF);
-	rect1y1 = o1->y + (s1->bbox.y1 << CSF);
-	rect1y2 = o1->y + (s1->bbox.y2 << CSF);
+	rect1x1 = o1->Left();
+	rect1x2 = o1->Right();
+	rect1y1 = o1->Top();
+	rect1y2 = o1->Bottom();
 	
 	// get the bounding rectangle of the second object
-	rect2x1 = o2->x + (s2->bbox.x1 << CSF);
-	rect2x2 = o2->x + (s2->bbox.x2 << CSF);
-	rect2y1 = o2->y + (s2->bbox.y1 << CSF);
-	rect2y2 = o2->y + (s2->bbox.y2 << CSF);
+	rect2x1 = o2->Left();
+	rect2x2 = o2->Right();
+	rect2y1 = o2->Top();
+	rect2y2 = o2->Bottom();
 	
 	// find out if the rectangles overlap
 	if ((rect1x1 < rect2x1) && (rect1x2 < rect2x1)) return false;
@@ -119,25 +135,28 @@ int32_t rect2x1, rect2y1, rect2x2, rect2y2;
 // returns true if the solidity boxes of the two given objects are touching
 bool solidhitdetect(Object *o1, Object *o2)
 {
-SIFSprite *s1, *s2;
 int32_t rect1x1, rect1y1, rect1x2, rect1y2;
 int32_t rect2x1, rect2y1, rect2x2, rect2y2;
 	
-	// get the sprites used by the two objects
-	s1 = o1->Sprite();
-	s2 = o2->Sprite();
+	if (shadow_enabled)
+	{
+		shadow_boxes("solidhitdetect", o1, &sprites[o1->sprite].solidbox, \
+					o1->SolidLeft(), o1->SolidTop(), o1->SolidRight(), o1->SolidBottom());
+		shadow_boxes("solidhitdetect", o2, &sprites[o2->sprite].solidbox, \
+					o2->SolidLeft(), o2->SolidTop(), o2->SolidRight(), o2->SolidBottom());
+	}
 	
 	// get the bounding rectangle of the first object
-	rect1x1 = o1->x + (s1->solidbox.x1 << CSF);
-	rect1x2 = o1->x + (s1->solidbox.x2 << CSF);
-	rect1y1 = o1->y + (s1->solidbox.y1 << CSF);
-	rect1y2 = o1->y + (s1->solidbox.y2 << CSF);
+	rect1x1 = o1->SolidLeft();
+	rect1x2 = o1->SolidRight();
+	rect1y1 = o1->SolidTop();
+	rect1y2 = o1->SolidBottom();
 	
 	// get the bounding rectangle of the second object
-	rect2x1 = o2->x + (s2->solidbox.x1 << CSF);
-	rect2x2 = o2->x + (s2->solidbox.x2 << CSF);
-	rect2y1 = o2->y + (s2->solidbox.y1 << CSF);
-	rect2y2 = o2->y + (s2->solidbox.y2 << CSF);
+	rect2x1 = o2->SolidLeft();
+	rect2x2 = o2->SolidRight();
+	rect2y1 = o2->SolidTop();
+	rect2y2 = o2->SolidBottom();
 	
 	// find out if the rectangles overlap
 	if ((rect1x1 < rect2x1) && (rect1x2 < rect2x1)) return false;
@@ -148,6 +167,23 @@ int32_t rect2x1, rect2y1, rect2x2, rect2y2;
 	return true;
 }
 
+// compares the box an object has cached (x1, y1, x2, y2; as returned by it's
+// Left() etc) with the one it's sprite actually has right now.
+static void shadow_boxes(const char *kernel, Object *o, SIFRect *ref, int x1, int y1, int x2, int y2)
+{
+	x1 -= o->x; x2 -= o->x;
+	y1 -= o->y; y2 -= o->y;
+	
+	if (x1 != (ref->x1 << CSF) || y1 != (ref->y1 << CSF) || \
+		x2 != (ref->x2 << CSF) || y2 != (ref->y2 << CSF))
+	{
+		Shadow::Mismatch(kernel, "%s (sprite %d, frame %d) has a box of [%d,%d]-[%d,%d], not [%d,%d]-[%d,%d] (in CSF units)", \
+						DescribeObjectType(o->type), o->sprite, o->frame, \
+						x1, y1, x2, y2, \
+						ref->x1 << CSF, ref->y1 << CSF, ref->x2 << CSF, ref->y2 << CSF);
+	}
+}
+
 /*
 void c------------------------------() {}
 */
@@ -163,11 +199,91 @@ Object *o;
 	// the list and given a chance to run their AI routine before being displayed.
 	FOREACH_OBJECT(o)
 	{
-		if (!o->deleted)
+		// most objects have neither an AI routine nor a touch script;
+		// don't bother calling through for those.
+		if (!o->deleted && \
+			(objprop[o->type].ai_routines.ontick || (o->flags & FLAG_SCRIPTONTOUCH)))
+		{
+			// triggers only have anything to do when the player's in them
+			if (IsStaticTrigger(o) && !Triggers::IsTouching(o))
+				continue;
+			
 			o->RunAI();
+		}
 	}
 }
 
+// runs the "aftermove" AI routines, in the same order as RunAI,
+// of only those objects which have one.
+void Objects::RunAftermove(void)
+{
+Object *o;
+
+	// the next pointer is read after the routine returns, as FOREACH_OBJECT
+	// does, so objects it creates still get their aftermove this frame.
+	for(o = firstaftermove; o; o = o->next_aftermove)
+	{
+		if (!o->deleted)
+			o->OnAftermove();
+	}
+}
+
+/*
+void c------------------------------() {}
+*/
+
+// adds or removes o from the aftermove list according to it's current type.
+// called whenever an object's type is set.
+void Objects::UpdateAftermoveList(Object *o)
+{
+	if (!objprop[o->type].ai_routines.aftermove)
+	{
+		RemoveFromAftermoveList(o);
+		return;
+	}
+	
+	if (o->on_aftermove_list)
+		return;
+	
+	// keep the list in creation order. new objects are always at the end; for
+	// existing objects changing type, look back for the closest one on the list.
+	Object *before = NULL;
+	if (o != lastobject)
+	{
+		for(before = o->prev; before; before = before->prev)
+		{
+			if (before->on_aftermove_list)
+				break;
+		}
+	}
+	else
+	{
+		before = lastaftermove;
+	}
+	
+	if (before)
+	{
+		LL_INSERT_AFTER(o, before, prev_aftermove, next_aftermove, firstaftermove, lastaftermove);
+	}
+	else
+	{
+		LL_ADD_BEGIN(o, prev_aftermove, next_aftermove, firstaftermove, lastaftermove);
+	}
+	
+	o->on_aftermove_list = true;
+}
+
+void Objects::RemoveFromAftermoveList(Object *o)
+{
+	if (!o->on_aftermove_list)
+		return;
+	
+	// the object's own next_aftermove is left alone so that RunAftermove
+	// can carry on if an object takes itself off the list during it's routine.
+	LL_REMOVE(o, prev_aftermove, next_aftermove, firstaftermove, lastaftermove);
+	o->on_aftermove_list = false;
+}
+
 
 // the most important thing it does is apply x/y inertia to the objects.
 void Objects::PhysicsSim(void)
@@ -177,7 +293,8 @@ int xinertia, yinertia;
 
 	FOREACH_OBJECT(o)
 	{
-		if (o != player && !o->deleted)		// player is moved in PDoPhysics
+		// player is moved in PDoPhysics, and triggers don't move at all
+		if (o != player && !o->deleted && !IsStaticTrigger(o))
 		{
 			if (!(o->flags & FLAG_IGNORE_SOLID) && \
 				!(o->nxflags & NXFLAG_NO_RESET_YINERTIA))
@@ -203,6 +320,11 @@ int xinertia, yinertia;
 			{
 				o->PushPlayerOutOfWay(xinertia, yinertia);
 			}
+			else if (o->ibbox)
+			{
+				// objects with a compound bbox hurt you with their rectangles
+				o->ibbox->DealContactDamage();
+			}
 			else if (o->damage > 0)
 			{
 				// have enemies hurt you when you touch them
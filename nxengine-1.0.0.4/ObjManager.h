@@ -9,6 +9,10 @@ namespace Objects
 	
 	void RunAI(void);
 	void PhysicsSim(void);
+	void RunAftermove(void);
+	
+	void UpdateAftermoveList(Object *o);
+	void RemoveFromAftermoveList(Object *o);
 	
 	int IsRearTopAttack(Object *o);
 	
@@ -78,5 +82,6 @@ struct ObjProp
 extern ObjProp objprop[OBJ_LAST];
 extern Object *firstobject, *lastobject;
 extern Object *lowestobject, *highestobject;
+extern Object *firstaftermove, *lastaftermove;
 
 #endif
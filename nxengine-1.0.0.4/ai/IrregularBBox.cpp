@@ -7,6 +7,7 @@ bool IrregularBBox::init(Object *associatedObject, int max_rectangles)
 {
 	memset(&bbox, 0, sizeof(bbox));
 	this->num_bboxes = max_rectangles;
+	this->damage = 0;
 	this->assoc_object = associatedObject;
 	
 	if (num_bboxes >= IB_MAX_BBOXES)
@@ -16,25 +17,14 @@ bool IrregularBBox::init(Object *associatedObject, int max_rectangles)
 		return 1;
 	}
 	
-	for(int i=0;i<num_bboxes;i++)
-	{
-		bbox[i] = CreateObject(0, 0, OBJ_BBOX_PUPPET);
-		bbox[i]->sprite = SPR_BBOX_PUPPET_1 + i;
-		bbox[i]->hp = 1000;
-		bbox[i]->damage = 0;
-		bbox[i]->invisible = true;
-	}
-	
+	assoc_object->ibbox = this;
 	return 0;
 }
 
 void IrregularBBox::destroy()
 {
-	for(int i=0;i<num_bboxes;i++)
-	{
-		bbox[i]->Delete();
-		bbox[i] = NULL;
-	}
+	if (assoc_object && assoc_object->ibbox == this)
+		assoc_object->ibbox = NULL;
 	
 	num_bboxes = 0;
 	assoc_object = NULL;
@@ -44,25 +34,10 @@ void IrregularBBox::destroy()
 void c------------------------------() {}
 */
 
+// sets the contact damage dealt to the player by touching any of the rectangles
 void IrregularBBox::set_damage(int dmg)
 {
-	for(int i=0;i<num_bboxes;i++)
-		bbox[i]->damage = dmg;
-}
-
-// link damage hits on the bbox to damage on it's associated object, o
-void IrregularBBox::transmit_hits()
-{
-	if (!assoc_object) return;
-	
-	for(int i=0;i<num_bboxes;i++)
-	{
-		if (bbox[i]->hp < 1000)
-		{
-			assoc_object->DealDamage(1000 - bbox[i]->hp);
-			bbox[i]->hp = 1000;
-		}
-	}
+	this->damage = dmg;
 }
 
 /*
@@ -74,7 +49,7 @@ void IrregularBBox::place(void (*placefunc)(void *userparm), void *userparm)
 	// first assume all disabled
 	for(int i=0;i<num_bboxes;i++)
 	{
-		bbox[i]->y = -1024;		// effectively disables it
+		bbox[i].enabled = false;
 	}
 	
 	// ask object to place it's bboxes as it wishes for this frame
@@ -91,30 +66,75 @@ void IrregularBBox::set_bbox(int index, int x, int y, int w, int h, uint32_t fla
 		return;
 	}
 	
-	Object *box = bbox[index];
+	IBRect *box = &bbox[index];
 	
 	// coordinates passed in here are for the right-facing frame,
 	// if we are currently left-facing then flip them.
 	if (assoc_object->dir == LEFT)
 		x = sprites[assoc_object->sprite].w - x - w;
 	
-	box->x = assoc_object->x + (x << CSF);
-	box->y = assoc_object->y + (y << CSF);
+	box->x1 = (x << CSF);
+	box->y1 = (y << CSF);
+	box->x2 = ((x + w - 1) << CSF);
+	box->y2 = ((y + h - 1) << CSF);
 	
-	sprites[box->sprite].bbox.x1 = 0;
-	sprites[box->sprite].bbox.y1 = 0;
-	sprites[box->sprite].bbox.x2 = (w - 1);
-	sprites[box->sprite].bbox.y2 = (h - 1);
-	
-	box->flags &= ~(FLAG_SHOOTABLE | FLAG_INVULNERABLE);
-	box->flags |= flags;
-	
-	// nitpicking perfect sync for this frame since we are not aftermove
-	box->x += assoc_object->xinertia;
-	box->y += assoc_object->yinertia;
+	box->flags = (flags & (FLAG_SHOOTABLE | FLAG_INVULNERABLE));
+	box->enabled = true;
 }
 
+/*
+void c------------------------------() {}
+*/
 
+// returns the flags of the first enabled rectangle which is touching
+// the bbox of the given object, or 0 if none of them are.
+uint32_t IrregularBBox::hitdetect(Object *other)
+{
+	if (!assoc_object) return 0;
+	
+	int32_t x1 = other->Left();
+	int32_t x2 = other->Right();
+	int32_t y1 = other->Top();
+	int32_t y2 = other->Bottom();
+	
+	for(int i=0;i<num_bboxes;i++)
+	{
+		IBRect *box = &bbox[i];
+		if (!box->enabled || !box->flags) continue;
+		
+		if (assoc_object->x + box->x2 < x1) continue;
+		if (assoc_object->x + box->x1 > x2) continue;
+		if (assoc_object->y + box->y2 < y1) continue;
+		if (assoc_object->y + box->y1 > y2) continue;
+		
+		return box->flags;
+	}
+	
+	return 0;
+}
 
-
+// hurts the player if they are touching any of the enabled rectangles.
+void IrregularBBox::DealContactDamage()
+{
+	if (damage <= 0 || !assoc_object)
+		return;
+	
+	// no contact damage to player while scripts running
+	if (GetCurrentScript() != -1 || player->inputs_locked)
+		return;
+	
+	for(int i=0;i<num_bboxes;i++)
+	{
+		IBRect *box = &bbox[i];
+		if (!box->enabled) continue;
+		
+		if (player->Right() < assoc_object->x + box->x1) continue;
+		if (player->Left() > assoc_object->x + box->x2) continue;
+		if (player->Bottom() < assoc_object->y + box->y1) continue;
+		if (player->Top() > assoc_object->y + box->y2) continue;
+		
+		hurtplayer(damage);
+		return;
+	}
+}
 
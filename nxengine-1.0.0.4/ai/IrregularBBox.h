@@ -1,11 +1,22 @@
-
 #ifndef _IRREGULARBBOX_H
 #define _IRREGULARBBOX_H
 
 
 #define IB_MAX_BBOXES		4
 
+// one rectangle of a compound bbox, relative to the associated
+// object's position and already flipped for it's current direction.
+struct IBRect
+{
+	int32_t x1, y1, x2, y2;		// CSF'd
+	uint32_t flags;				// FLAG_SHOOTABLE and/or FLAG_INVULNERABLE
+	bool enabled;
+};
 
+// a compound bounding box for bosses whose shape isn't well-represented by
+// a single rectangle. once init()'d, the associated object is hit by shots
+// and deals contact damage to the player through these rectangles instead
+// of through it's sprite's bbox.
 class IrregularBBox
 {
 public:
@@ -13,14 +24,17 @@ public:
 	void destroy();
 	
 	void set_damage(int dmg);
-	void transmit_hits();
 	
 	void place(void (*placefunc)(void *userparm), void *userparm);
 	void set_bbox(int index, int x, int y, int w, int h, uint32_t flags);
+	
+	uint32_t hitdetect(Object *other);
+	void DealContactDamage();
 
 private:
-	Object *bbox[IB_MAX_BBOXES];
+	IBRect bbox[IB_MAX_BBOXES];
 	int num_bboxes;
+	int damage;
 	Object *assoc_object;
 	
 };
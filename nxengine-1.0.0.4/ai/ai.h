@@ -60,7 +60,8 @@ void SmokeXY(int x, int y, int nclouds, int rangex=0, int rangey=0, Object *push
 #define YACCEL(SPD) { o->yinertia += (o->dir == DOWN) ? (SPD) : -(SPD); }
 
 #define COPY_PFBOX	\
-	{ sprites[o->sprite].bbox = sprites[o->sprite].frame[o->frame].dir[o->dir].pf_bbox; }
+	{ sprites[o->sprite].bbox = sprites[o->sprite].frame[o->frame].dir[o->dir].pf_bbox; \
+	  sprites_geom_changed(); }
 
 #define AIDEBUG	\
 {	\
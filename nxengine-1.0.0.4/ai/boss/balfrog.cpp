@@ -77,16 +77,16 @@ void BalfrogBoss::OnMapEntry(void)
 	game.stageboss.object = o;
 	
 	o->hp = 300;
-	o->damage = 0;	// damage comes from our bbox puppets, not our own bbox
+	o->damage = 0;	// damage comes from our compound bbox, not our own bbox
 	o->flags |= FLAG_SHOW_FLOATTEXT;
 	
 	o->sprite = SPR_BALFROG;
 	o->dir = RIGHT;
 	o->invisible = true;
 	
-	// setup the bounding box objects--this boss has an irregular bounding box
-	// and so we simulate that by having three invisible objects which are wired
-	// to transmit hits to the real Balfrog boss object.
+	// setup the bounding box--this boss has an irregular bounding box
+	// and so it's made up of three rectangles which replace the object's own bbox
+	// for shot hits and contact damage.
 	frog.bboxes.init(o, 3);
 	frog.bboxes.set_damage(5);
 	frog.bbox_mode = BM_DISABLED;
@@ -120,9 +120,7 @@ void BalfrogBoss::Run()
 		// don't limit upwards inertia or Big Jump will fail
 		if (o->yinertia > 0x5FF) o->yinertia = 0x5FF;
 		
-		// link our "irregular" bbox (actually composed of multiple "puppet" bboxes)
-		// to our real object.
-		frog.bboxes.transmit_hits();
+		// update the rectangles of our "irregular" bbox for this frame's pose
 		frog.bboxes.place(&call_place_bboxes, this);
 	}
 }
@@ -97,6 +97,7 @@ void BallosBoss::OnMapEntry(void)
 	sprites[main->sprite].solidbox = sprites[main->sprite].bbox;
 	sprites[body->sprite].solidbox = sprites[body->sprite].bbox;
 	sprites[shield->sprite].solidbox = sprites[shield->sprite].bbox;
+	sprites_geom_changed();
 	
 	// body and eyes are both directly shootable during one form or another
 	// but should not shake as their damage is to be transferred to main object.
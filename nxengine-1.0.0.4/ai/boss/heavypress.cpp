@@ -41,6 +41,7 @@ void HeavyPress::OnMapEntry(void)
 	fullwidth_bbox = sprites[o->sprite].frame[2].dir[0].pf_bbox;
 	
 	sprites[o->sprite].bbox = fullwidth_bbox;
+	sprites_geom_changed();
 }
 
 /*
@@ -80,6 +81,7 @@ void HeavyPress::Run()
 			// then switch to small pfbox where we're only hittable in the center
 			o->frame = 0;
 			sprites[o->sprite].bbox = center_bbox;
+			sprites_geom_changed();
 			
 			o->flags |= FLAG_SHOOTABLE;
 			o->flags &= ~FLAG_INVULNERABLE;
@@ -150,6 +152,7 @@ void HeavyPress::run_defeated()
 			if (shield_left) { shield_left->Delete(); shield_left = NULL; }
 			if (shield_right) { shield_right->Delete(); shield_right = NULL; }
 			sprites[o->sprite].bbox = fullwidth_bbox;
+			sprites_geom_changed();
 			
 			// get rid of enemies--the butes can stay, though.
 			KillObjectsOfType(OBJ_HP_LIGHTNING);
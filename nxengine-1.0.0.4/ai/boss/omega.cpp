@@ -327,10 +327,10 @@ void OmegaBoss::Run(void)
 				// but bottom of player's bounding box is not...
 				if (player->blockd)
 				{
-					int omg_bottom = o->y + (sprites[o->sprite].solidbox.y2 << CSF);
+					int omg_bottom = o->SolidBottom();
 					if (player->y <= omg_bottom)
 					{
-						if (player->y + (sprites[player->sprite].solidbox.y2 << CSF) >= omg_bottom)
+						if (player->SolidBottom() >= omg_bottom)
 						{
 							if (hitdetect(o, player))	// easy way to verify the X's are lined up
 							{	// SQUISH!
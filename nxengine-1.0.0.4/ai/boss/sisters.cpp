@@ -509,6 +509,7 @@ void SistersBoss::head_set_bbox(int index)
 	
 	sprite->bbox.y1 = head_bboxes[frame].y1;
 	sprite->bbox.y2 = head_bboxes[frame].y2;
+	sprites_geom_changed();
 	
 	o->flags &= ~(FLAG_SHOOTABLE | FLAG_INVULNERABLE);
 	o->flags |= head_bboxes[frame].flags;
@@ -125,6 +125,8 @@ Object *o;
 		sprites[bbox[i]->sprite].bbox = core_bboxes[i].rect;
 	}
 	
+	sprites_geom_changed();
+	
 	//o->BringToFront();
 }
 
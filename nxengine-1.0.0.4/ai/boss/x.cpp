@@ -773,6 +773,7 @@ int i;
 	sprites[SPR_X_DOOR].frame[0].dir[LEFT].drawpoint.y = 16;
 	sprites[SPR_X_DOOR].frame[0].dir[RIGHT].drawpoint.x = -9;
 	sprites[SPR_X_DOOR].frame[0].dir[RIGHT].drawpoint.y = 16;
+	sprites_geom_changed();
 }
 
 // create an object and record it as a piece of the monster
@@ -311,6 +311,7 @@ void ai_counter_bomb(Object *o)
 					sprites[o->sprite].bbox.y1 = -100;
 					sprites[o->sprite].bbox.x2 = 128;
 					sprites[o->sprite].bbox.y2 = 100;
+					sprites_geom_changed();
 					o->damage = 30;
 					
 					o->yinertia = 0;
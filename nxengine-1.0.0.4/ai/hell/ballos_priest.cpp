@@ -147,6 +147,7 @@ void ai_ballos_priest(Object *o)
 	if (o->dirparam != o->dir)
 	{
 		sprites[o->sprite].bbox = sprites[o->sprite].frame[0].dir[o->dir].pf_bbox;
+		sprites_geom_changed();
 		o->dirparam = o->dir;
 	}
 }
@@ -772,6 +772,7 @@ void ai_deleet(Object *o)
 					sprites[o->sprite].bbox.x2 = 48;
 					sprites[o->sprite].bbox.y1 = -48;
 					sprites[o->sprite].bbox.y2 = 48;
+					sprites_geom_changed();
 					o->damage = 12;
 					
 					quake(10);
@@ -241,8 +241,8 @@ int pbottom, crocbottom;
 			if (pdistlx(19 << CSF))
 			{
 				// check if bottoms of player and croc are near
-				pbottom = player->y + (sprites[player->sprite].bbox.y2 << CSF);
-				crocbottom = o->y + (sprites[o->sprite].bbox.y2 << CSF) + 0x600;
+				pbottom = player->Bottom();
+				crocbottom = o->Bottom() + 0x600;
 				
 				if (pbottom <= crocbottom && crocbottom - pbottom < (12 << CSF))
 				{	// attack!!
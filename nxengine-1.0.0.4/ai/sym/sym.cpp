@@ -132,6 +132,9 @@ void ai_hvtrigger(Object *o)
 			o->hvt.y1 = 0;
 			o->hvt.y2 = (map.ysize * TILE_H) << CSF;
 		}
+		
+		// it can go in the index now that it has it's box
+		Triggers::Invalidate();
 	}
 	
 	if (game.debug.DrawBoundingBoxes)
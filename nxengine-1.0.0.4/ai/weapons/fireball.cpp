@@ -59,11 +59,12 @@ void ai_fireball(Object *o)
 	}
 	
 	Object *enemy;
-	if ((enemy = check_hit_enemy(o)))
+	uint32_t hitflags;
+	if ((enemy = check_hit_enemy(o, 0, &hitflags)))
 	{
 		// bounce off of invulnerable non-enemy objects instead of dissipating
 		// (prevents incorrect dissipation if a fireball hits the Lift in Almond)
-		if ((enemy->flags & FLAG_INVULNERABLE) && enemy->damage == 0)
+		if ((hitflags & FLAG_INVULNERABLE) && enemy->damage == 0 && !enemy->ibbox)
 		{
 			static const Point embedpt[] = { 8, 8 };
 			static const Point pcheckl[] = { { -1, 4 }, { -1, 12 } };
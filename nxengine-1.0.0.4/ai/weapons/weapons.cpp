@@ -46,27 +46,43 @@ uint8_t run_shot(Object *o, bool destroys_blocks)
 void c------------------------------() {}
 */
 
+// returns the SHOOTABLE/INVULNERABLE flags of the part of enemy which the shot is
+// touching, or 0 if it isn't touching any part of it which can be shot at.
+// for most objects this is just their own flags, but objects with a compound
+// bbox can have parts which are shootable and parts which are invulnerable.
+static uint32_t get_hit_flags(Object *enemy, Object *shot)
+{
+	if (enemy->ibbox)
+		return enemy->ibbox->hitdetect(shot);
+	
+	if (enemy->flags & (FLAG_SHOOTABLE | FLAG_INVULNERABLE))
+	{
+		if (hitdetect(enemy, shot))
+			return enemy->flags;
+	}
+	
+	return 0;
+}
+
 // checks if the shot passed in has struck an enemy. if so, returns the enemy.
 // optional parameter flags_to_exclude lets you pass through enemies with
 // certain flags set (such as if you don't want to try to hurt invulnerable enemies).
-Object *check_hit_enemy(Object *shot, uint32_t flags_to_exclude)
+// if hitflags is given, it receives the flags of the part of the enemy that was hit,
+// which callers should use instead of enemy->flags to decide if it was invulnerable.
+Object *check_hit_enemy(Object *shot, uint32_t flags_to_exclude, uint32_t *hitflags)
 {
 	Object *enemy;
 	FOREACH_OBJECT(enemy)
 	{
-		if (enemy->flags & (FLAG_SHOOTABLE | FLAG_INVULNERABLE))
+		uint32_t flags = get_hit_flags(enemy, shot);
+		if (flags && (flags & flags_to_exclude) == 0)
 		{
-			if ((enemy->flags & flags_to_exclude) == 0)
+			// can't hit an enemy by shooting up when standing on it
+			// (added for omega battle but good probably in other times too)
+			if (player->riding != enemy || shot->yinertia >= 0)
 			{
-				if (hitdetect(enemy, shot))
-				{
-					// can't hit an enemy by shooting up when standing on it
-					// (added for omega battle but good probably in other times too)
-					if (player->riding != enemy || shot->yinertia >= 0)
-					{
-						return enemy;
-					}
-				}
+				if (hitflags) *hitflags = flags;
+				return enemy;
 			}
 		}
 	}
@@ -82,15 +98,21 @@ Object *check_hit_enemy(Object *shot, uint32_t flags_to_exclude)
 Object *damage_enemies(Object *o, uint32_t flags_to_exclude)
 {
 Object *enemy;
+uint32_t hitflags;
 
 	// first check if we hit an enemy
-	if ((enemy = check_hit_enemy(o, flags_to_exclude)))
+	if ((enemy = check_hit_enemy(o, flags_to_exclude, &hitflags)))
 	{
-		if (enemy->flags & FLAG_INVULNERABLE)
+		if (hitflags & FLAG_INVULNERABLE)
 		{
 			shot_spawn_effect(o, EFFECT_STARSOLID);
 			sound(SND_TINK);
 		}
+		else if (enemy->ibbox)
+		{
+			// compound-bbox bosses don't splatter where the shot hit
+			enemy->DealDamage(o->shot.damage);
+		}
 		else
 		{
 			enemy->DealDamage(o->shot.damage, o);
@@ -111,25 +133,24 @@ int count = 0;
 
 	FOREACH_OBJECT(enemy)
 	{
-		if (enemy->flags & (FLAG_SHOOTABLE | FLAG_INVULNERABLE))
+		uint32_t flags = get_hit_flags(enemy, o);
+		if (flags && (flags & flags_to_exclude) == 0)
 		{
-			if ((enemy->flags & flags_to_exclude) == 0)
+			if (flags & FLAG_INVULNERABLE)
+			{
+				shot_spawn_effect(o, EFFECT_STARSOLID);
+				sound(SND_TINK);
+			}
+			else if (enemy->ibbox)
 			{
-				if (hitdetect(enemy, o))
-				{
-					if (enemy->flags & FLAG_INVULNERABLE)
-					{
-						shot_spawn_effect(o, EFFECT_STARSOLID);
-						sound(SND_TINK);
-					}
-					else
-					{
-						enemy->DealDamage(o->shot.damage, o);
-					}
-					
-					count++;
-				}
+				enemy->DealDamage(o->shot.damage);
 			}
+			else
+			{
+				enemy->DealDamage(o->shot.damage, o);
+			}
+			
+			count++;
 		}
 	}
 	
@@ -3,6 +3,7 @@
 #define _WEAPONS_H
 
 #include "../stdai.h"
+#include "../IrregularBBox.h"
 
 uint8_t run_shot(Object *o, bool destroys_blocks);
 enum run_shot_result
@@ -13,7 +14,7 @@ enum run_shot_result
 	RS_TTL_EXPIRED
 };
 
-Object *check_hit_enemy(Object *o, uint32_t flags_to_exclude=0);
+Object *check_hit_enemy(Object *o, uint32_t flags_to_exclude=0, uint32_t *hitflags=NULL);
 Object *damage_enemies(Object *o, uint32_t flags_to_exclude=0);
 int damage_multiple_enemies(Object *o, uint32_t flags_to_exclude=0);
 
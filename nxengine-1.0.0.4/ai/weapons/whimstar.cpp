@@ -105,10 +105,11 @@ void c------------------------------() {}
 // invisible trail object left by whimsical star which damages enemies
 void ai_whimsical_star(Object *o)
 {
-	Object *enemy = check_hit_enemy(o);
+	uint32_t hitflags;
+	Object *enemy = check_hit_enemy(o, 0, &hitflags);
 	if (enemy)
 	{
-		if (!(enemy->flags & FLAG_INVULNERABLE))
+		if (!(hitflags & FLAG_INVULNERABLE))
 		{
 			enemy->DealDamage(1);
 		}
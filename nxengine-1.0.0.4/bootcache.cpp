@@ -0,0 +1,312 @@
+
+#include "nx.h"
+#include "bootcache.h"
+#include "common/checksum.h"
+#include "libretro/libretro_shared.h"
+
+#ifdef HAVE_MMAP
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+#include "bootcache.fdh"
+
+#define BC_HEADER_SIZE		12		// magick, exe size, exe crc
+
+static struct
+{
+	uint32_t exe_size;
+	uint32_t exe_crc;
+	
+	// the whole cache file as read or mapped from disk, if it's valid for this exe,
+	// and the section data inside it (just past the header).
+	uint8_t *file;
+	int file_size;
+	bool mapped;
+	
+	uint8_t *image;
+	int image_size;
+	
+	// sections generated during a cold boot, to be written out by bootcache_commit
+	DBuffer pending;
+	int npending;
+} bc;
+
+// checksums the exe and tries to load an existing boot cache made from it.
+// returns true if there is a valid cache; any sections that aren't found in it
+// should be regenerated and handed to bootcache_add().
+bool bootcache_open(FILE *exefp)
+{
+char fname[1024];
+uint8_t *exedata;
+	
+	bootcache_close();
+	if (!exefp) return 0;
+	
+	// signature the exe, so we know if the cache was made from a different one
+	bc.exe_size = filesize(exefp);
+	exedata = (uint8_t *)malloc(bc.exe_size);
+	if (!exedata) return 0;
+	
+	fseek(exefp, 0, SEEK_SET);
+	fread(exedata, bc.exe_size, 1, exefp);
+	
+	crc_init();
+	bc.exe_crc = crc_calc(exedata, bc.exe_size);
+	free(exedata);
+	
+	retro_create_path_string(fname, sizeof(fname), g_dir, BOOTCACHE_FILENAME);
+	if (!load_file(fname))
+	{
+		NX_LOG("bootcache_open: %s not exist; doing a cold boot\n", fname);
+		return 0;
+	}
+	
+	// like the pxt cache this file is endian-specific, so the header is
+	// read raw in order that the check fails if it's moved between systems.
+	uint32_t header[3];
+	memset(header, 0, sizeof(header));
+	if (bc.file_size >= BC_HEADER_SIZE)
+		memcpy(header, bc.file, BC_HEADER_SIZE);
+	
+	if (header[0] != BOOTCACHE_MAGICK || \
+		header[1] != bc.exe_size || header[2] != bc.exe_crc)
+	{
+		NX_LOG("bootcache_open: %s is stale; doing a cold boot\n", fname);
+		bootcache_close();
+		return 0;
+	}
+	
+	bc.image = bc.file + BC_HEADER_SIZE;
+	bc.image_size = bc.file_size - BC_HEADER_SIZE;
+	
+	NX_LOG("bootcache_open: warm boot from %s\n", fname);
+	return 1;
+}
+
+// brings the whole cache file into memory. where possible it's mapped read-only
+// rather than read, so that if several instances of the engine are running at once
+// they all share one physical copy of whatever they point into it.
+static bool load_file(const char *fname)
+{
+#ifdef HAVE_MMAP
+	int fd = open(fname, O_RDONLY);
+	if (fd != -1)
+	{
+		struct stat st;
+		void *map = MAP_FAILED;
+		
+		if (fstat(fd, &st) == 0 && st.st_size > 0)
+			map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		
+		close(fd);		// the mapping stays valid without it
+		
+		if (map != MAP_FAILED)
+		{
+			bc.file = (uint8_t *)map;
+			bc.file_size = st.st_size;
+			bc.mapped = true;
+			return 1;
+		}
+	}
+#endif
+	
+	FILE *fp = fopen(fname, "rb");
+	if (!fp) return 0;
+	
+	bc.file_size = filesize(fp);
+	bc.file = (uint8_t *)malloc(bc.file_size);
+	
+	if (!bc.file || fread(bc.file, bc.file_size, 1, fp) != 1)
+	{
+		NX_ERR("bootcache: failed to read %s\n", fname);
+		if (bc.file) free(bc.file);
+		bc.file = NULL;
+		bc.file_size = 0;
+		fclose(fp);
+		return 0;
+	}
+	
+	fclose(fp);
+	bc.mapped = false;
+	return 1;
+}
+
+bool bootcache_is_warm(void)
+{
+	return (bc.image != NULL);
+}
+
+// returns a pointer to the data of the given section of the loaded cache,
+// or NULL if it doesn't have one. sections are 4-byte aligned in the image.
+// the data is read-only and remains valid until bootcache_close(), so callers
+// may keep pointers into it rather than copying it out.
+uint8_t *bootcache_find(uint32_t tag, int *length_out)
+{
+	uint8_t *ptr = bc.image;
+	uint8_t *end = bc.image + bc.image_size;
+	
+	if (!ptr) return NULL;
+	
+	// each section is a tag, length and then that many bytes of data,
+	// padded out to the next multiple of 4.
+	while(ptr + 8 <= end)
+	{
+		uint32_t sect_tag, sect_len;
+		memcpy(&sect_tag, ptr, 4);
+		memcpy(&sect_len, ptr + 4, 4);
+		ptr += 8;
+		
+		if (sect_len > (uint32_t)(end - ptr))
+			break;
+		
+		if (sect_tag == tag)
+		{
+			if (length_out) *length_out = sect_len;
+			return ptr;
+		}
+		
+		ptr += (sect_len + 3) & ~3;
+	}
+	
+	return NULL;
+}
+
+// returns the checksum of the exe the engine was booted from
+uint32_t bootcache_exe_crc(void)
+{
+	return bc.exe_crc;
+}
+
+// adds a freshly-generated section, to be saved into the cache by bootcache_commit.
+void bootcache_add(uint32_t tag, DBuffer *data)
+{
+	bc.pending.Append32(tag);
+	bc.pending.Append32(data->Length());
+	bc.pending.AppendData(data->Data(), data->Length());
+	
+	while(bc.pending.Length() & 3)
+		bc.pending.Append8(0);
+	
+	bc.npending++;
+}
+
+// called once the engine has finished booting successfully.
+// writes out a new cache if any sections had to be regenerated.
+// the loaded image is kept, as the rest of the engine may still be using it.
+void bootcache_commit(void)
+{
+char fname[1024], tempname[1024];
+	
+	if (bc.npending)
+	{
+		// the new cache is written under a temporary name and then moved into place,
+		// so that another instance which has the old one mapped keeps a valid copy,
+		// and so nobody ever sees a half-written file.
+		retro_create_path_string(fname, sizeof(fname), g_dir, BOOTCACHE_FILENAME);
+		retro_create_path_string(tempname, sizeof(tempname), g_dir, BOOTCACHE_FILENAME ".tmp");
+		
+		FILE *fp = fopen(tempname, "wb");
+		if (fp)
+		{
+			uint32_t header[3] = { BOOTCACHE_MAGICK, bc.exe_size, bc.exe_crc };
+			fwrite(header, BC_HEADER_SIZE, 1, fp);
+			
+			// keep any sections which were already good, then add the new ones.
+			// old copies of the sections which were regenerated are dropped, as
+			// bootcache_find would otherwise keep finding them instead.
+			write_old_sections(fp);
+			fwrite(bc.pending.Data(), bc.pending.Length(), 1, fp);
+			
+			NX_LOG("bootcache_commit: created %s; %d bytes\n", fname, (int)ftell(fp));
+			fclose(fp);
+			
+			// (rename won't replace an existing file everywhere, so retry it without)
+			if (rename(tempname, fname) && (remove(fname), rename(tempname, fname)))
+			{
+				NX_ERR("bootcache_commit: failed to rename '%s' to '%s'\n", tempname, fname);
+				remove(tempname);
+			}
+		}
+		else
+		{
+			NX_ERR("bootcache_commit: failed open: '%s'\n", tempname);
+		}
+	}
+	
+	bc.pending.Clear();
+	bc.npending = 0;
+}
+
+// writes out each section of the loaded image which hasn't been replaced by a pending one
+static void write_old_sections(FILE *fp)
+{
+	uint8_t *ptr = bc.image;
+	uint8_t *end = bc.image + bc.image_size;
+	
+	if (!ptr) return;
+	
+	while(ptr + 8 <= end)
+	{
+		uint32_t sect_tag, sect_len;
+		memcpy(&sect_tag, ptr, 4);
+		memcpy(&sect_len, ptr + 4, 4);
+		
+		if (sect_len > (uint32_t)(end - (ptr + 8)))
+			break;
+		
+		uint32_t sect_size = 8 + ((sect_len + 3) & ~3);
+		if (sect_size > (uint32_t)(end - ptr))
+			sect_size = (end - ptr);
+		
+		if (!is_pending(sect_tag))
+			fwrite(ptr, sect_size, 1, fp);
+		
+		ptr += sect_size;
+	}
+}
+
+// returns true if a section with the given tag has been added since the last commit
+static bool is_pending(uint32_t tag)
+{
+	uint8_t *ptr = bc.pending.Data();
+	uint8_t *end = ptr + bc.pending.Length();
+	
+	while(ptr + 8 <= end)
+	{
+		uint32_t sect_tag, sect_len;
+		memcpy(&sect_tag, ptr, 4);
+		memcpy(&sect_len, ptr + 4, 4);
+		
+		if (sect_tag == tag)
+			return true;
+		
+		ptr += 8 + ((sect_len + 3) & ~3);
+	}
+	
+	return false;
+}
+
+// releases the loaded image. anything pointing into it must be freed first.
+void bootcache_close(void)
+{
+	if (bc.file)
+	{
+	#ifdef HAVE_MMAP
+		if (bc.mapped)
+			munmap(bc.file, bc.file_size);
+		else
+	#endif
+			free(bc.file);
+	}
+	
+	bc.file = bc.image = NULL;
+	bc.file_size = bc.image_size = 0;
+	bc.mapped = false;
+	
+	bc.pending.Clear();
+	bc.npending = 0;
+}
+
@@ -0,0 +1,30 @@
+
+#ifndef _BOOTCACHE_H
+#define _BOOTCACHE_H
+
+// the boot cache is a snapshot of data which is costly to generate at startup,
+// but which is always the same for a given Doukutsu.exe (such as the synthesized
+// sound effects). it's written after the first successful boot and used on
+// later boots, as long as the exe still checksums the same.
+// on systems with HAVE_MMAP it's mapped read-only and shared, and the engine
+// keeps pointers into it (e.g. the sound effect PCM) instead of private copies,
+// so running several instances at once doesn't multiply that memory.
+
+#define BOOTCACHE_MAGICK		'NXB3'
+#define BOOTCACHE_FILENAME		"bootcache.dat"
+
+// section tags
+#define BC_SOUNDFX				'SNDF'
+#define BC_DRUMS				'DRUM'
+
+class DBuffer;
+
+bool bootcache_open(FILE *exefp);
+bool bootcache_is_warm(void);
+uint8_t *bootcache_find(uint32_t tag, int *length_out);
+uint32_t bootcache_exe_crc(void);
+void bootcache_add(uint32_t tag, DBuffer *data);
+void bootcache_commit(void);
+void bootcache_close(void);
+
+#endif
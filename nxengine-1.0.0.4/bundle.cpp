@@ -0,0 +1,478 @@
+
+// per-stage asset bundles; see bundle.h.
+
+#include "nx.h"
+#include "bundle.h"
+#include "bootcache.h"
+#include "common/lz.h"
+#include "common/checksum.h"
+#include "libretro/libretro_shared.h"
+
+#ifndef _XBOX1
+	#include <sys/stat.h>
+#endif
+
+#include "bundle.fdh"
+
+#define BUNDLE_HEADER_SIZE		20		// magick, version, exe crc, number of files, crc of the rest
+#define BUNDLE_INDEX_SIZE		(BUNDLE_NAME_LEN + 16)	// name, packed offset, length, packed length, mtime
+
+static struct
+{
+	// the bundle of the current stage, if it has one, as it was read from disk.
+	// offsets in the index are from the start of the packed data, which follows right after it.
+	uint8_t *file;
+	int file_size;
+	int nfiles;
+	const uint8_t *index;
+	const uint8_t *data;
+	
+	// the stage whose files are being noted down, to be bundled when it's left
+	bool recording;
+	int rec_stage;
+	int generation;			// goes up with each stage recorded
+	StringList rec_files;
+} bnd;
+
+
+// called as a stage begins to load. writes out the bundle of the stage being left
+// if it was being recorded, then loads the new stage's bundle or starts recording it.
+void bundle_enter_stage(int stage_no)
+{
+char fname[MAXPATHLEN];
+
+	finish_recording();
+	free_bundle();
+	
+	if (settings->stage_bundles <= 0)
+		return;
+	
+	if (get_bundle_name(stage_no, fname))
+		return;
+	
+	if (load_bundle(fname))
+	{
+		bnd.recording = true;
+		bnd.rec_stage = stage_no;
+		bnd.generation++;
+		bnd.rec_files.MakeEmpty();
+	}
+}
+
+void bundle_close(void)
+{
+	finish_recording();
+	free_bundle();
+}
+
+/*
+void c------------------------------() {}
+*/
+
+// reads the whole of the given file into out, from the current stage's bundle
+// if it's in there, otherwise from disk. either way, it goes straight into out.
+bool bundle_read_file(const char *fname, DBuffer *out)
+{
+	const uint8_t *entry = find_entry(fname);
+	
+	if (entry)
+	{
+		const uint8_t *ptr = entry + BUNDLE_NAME_LEN;
+		const uint8_t *end = entry + BUNDLE_INDEX_SIZE;
+		
+		uint32_t offset = read_U32(&ptr, end);
+		uint32_t length = read_U32(&ptr, end);
+		uint32_t packed = read_U32(&ptr, end);
+		const uint8_t *src = bnd.data + offset;
+		
+		out->Clear();
+		out->SetLength(length);
+		
+		if (packed == length)
+		{
+			memcpy(out->Data(), src, length);
+			return 0;
+		}
+		
+		if (!lz_decompress(src, packed, out->Data(), length))
+			return 0;
+		
+		NX_ERR("bundle: failed to unpack '%s'; reading it from disk instead\n", fname);
+	}
+	
+	return read_from_disk(fname, out);
+}
+
+// returns the index entry of the given file if it's in the current stage's bundle,
+// or NULL if it isn't.
+static const uint8_t *find_entry(const char *fname)
+{
+	if (bnd.file)
+	{
+		const char *name = get_relative_name(fname);
+		const uint8_t *entry = bnd.index;
+		
+		for(int i=0;i<bnd.nfiles;i++)
+		{
+			if (!strncmp((const char *)entry, name, BUNDLE_NAME_LEN))
+				return entry;
+			
+			entry += BUNDLE_INDEX_SIZE;
+		}
+	}
+	
+	// anything loaded from disk while a stage is being recorded is part of it
+	bundle_note(fname);
+	return NULL;
+}
+
+static bool read_from_disk(const char *fname, DBuffer *out)
+{
+	FILE *fp = fopen(fname, "rb");
+	if (!fp) return 1;
+	
+	int length = filesize(fp);
+	
+	out->Clear();
+	out->SetLength(length);
+	
+	if (length > 0 && fread(out->Data(), length, 1, fp) != 1)
+	{
+		NX_ERR("bundle: failed to read '%s'\n", fname);
+		out->Clear();
+		fclose(fp);
+		return 1;
+	}
+	
+	fclose(fp);
+	return 0;
+}
+
+/*
+void c------------------------------() {}
+*/
+
+// returns nonzero if the current stage is being recorded. it's different for every
+// stage recorded, so things can tell if they've already been noted for this one.
+int bundle_recording(void)
+{
+	return bnd.recording ? bnd.generation : 0;
+}
+
+// notes that the given file is used by the stage being recorded. this is done
+// automatically for files loaded from disk, but things which were already in
+// memory from an earlier stage have to say so themselves.
+void bundle_note(const char *fname)
+{
+	if (!bnd.recording)
+		return;
+	
+	// they're found again by their names inside the data dir, to check they haven't changed
+	const char *name = get_relative_name(fname);
+	if (name == fname || strlen(name) >= BUNDLE_NAME_LEN)
+		return;
+	
+	if (bnd.rec_files.CountItems() < BUNDLE_MAX_FILES && \
+		!bnd.rec_files.ContainsString(fname))
+	{
+		bnd.rec_files.AddString(fname);
+	}
+}
+
+static void finish_recording(void)
+{
+	if (!bnd.recording)
+		return;
+	
+	bnd.recording = false;
+	
+	if (bnd.rec_files.CountItems())
+		write_bundle(bnd.rec_stage);
+	
+	bnd.rec_files.MakeEmpty();
+}
+
+// writes out the bundle of the stage that was being recorded
+static void write_bundle(int stage_no)
+{
+char fname[MAXPATHLEN], tempname[MAXPATHLEN];
+DBuffer index, data, contents, packed;
+int nfiles = 0;
+int offset = 0;
+
+	for(int i=0;i<bnd.rec_files.CountItems();i++)
+	{
+		const char *path = bnd.rec_files.StringAt(i);
+		uint32_t size, mtime;
+		
+		// the stamp is taken first, so that if it's changed while being read, it's seen as stale
+		if (get_file_stamp(path, &size, &mtime) || read_from_disk(path, &contents))
+			continue;
+		
+		char name[BUNDLE_NAME_LEN];
+		memset(name, 0, sizeof(name));
+		strcpy(name, get_relative_name(path));
+		
+		// stored as-is if it doesn't get any smaller; the packed length then equals the length
+		packed.Clear();
+		if (lz_compress(contents.Data(), contents.Length(), &packed) >= contents.Length())
+			packed.SetTo(contents.Data(), contents.Length());
+		
+		index.AppendData((uint8_t *)name, BUNDLE_NAME_LEN);
+		write_U32(&index, offset);
+		write_U32(&index, contents.Length());
+		write_U32(&index, packed.Length());
+		write_U32(&index, mtime);
+		
+		data.AppendData(packed.Data(), packed.Length());
+		offset += packed.Length();
+		nfiles++;
+	}
+	
+	// written under a temporary name and then moved into place,
+	// so that a half-written bundle is never picked up.
+	if (get_bundle_name(stage_no, fname))
+		return;
+	
+	if (snprintf(tempname, sizeof(tempname), "%s.tmp", fname) >= (int)sizeof(tempname))
+	{
+		NX_ERR("bundle: the path to '%s' is too long\n", fname);
+		return;
+	}
+	
+	FILE *fp = fopen(tempname, "wb");
+	if (!fp)
+	{
+		NX_ERR("bundle: failed to open '%s'\n", tempname);
+		return;
+	}
+	
+	fputl(BUNDLE_MAGICK, fp);
+	fputl(BUNDLE_VERSION, fp);
+	fputl(bootcache_exe_crc(), fp);
+	fputl(nfiles, fp);
+	fputl(crc_update(crc_calc(index.Data(), index.Length()), data.Data(), data.Length()), fp);
+	fwrite(index.Data(), index.Length(), 1, fp);
+	fwrite(data.Data(), data.Length(), 1, fp);
+	
+	NX_LOG("bundle: wrote %s; %d files, %d bytes\n", fname, nfiles, (int)ftell(fp));
+	fclose(fp);
+	
+	if (rename(tempname, fname) && (remove(fname), rename(tempname, fname)))
+	{
+		NX_ERR("bundle: failed to rename '%s' to '%s'\n", tempname, fname);
+		remove(tempname);
+	}
+}
+
+/*
+void c------------------------------() {}
+*/
+
+// brings in the whole bundle with one read and checks it's good to use.
+// the files are left packed until they're asked for.
+static bool load_bundle(const char *fname)
+{
+	FILE *fp = fopen(fname, "rb");
+	if (!fp) return 1;
+	
+	int size = filesize(fp);
+	uint8_t *file = (uint8_t *)malloc(size + 1);
+	
+	if (size < BUNDLE_HEADER_SIZE || fread(file, size, 1, fp) != 1)
+	{
+		NX_ERR("bundle: failed to read '%s'\n", fname);
+		free(file);
+		fclose(fp);
+		return 1;
+	}
+	
+	fclose(fp);
+	
+	const uint8_t *ptr = file;
+	const uint8_t *end = file + size;
+	
+	uint32_t magick = read_U32(&ptr, end);
+	uint32_t version = read_U32(&ptr, end);
+	uint32_t exe_crc = read_U32(&ptr, end);
+	int nfiles = read_U32(&ptr, end);
+	uint32_t crc = read_U32(&ptr, end);
+	
+	// it's rebuilt if the game data could have changed since
+	if (magick != BUNDLE_MAGICK || version != BUNDLE_VERSION || exe_crc != bootcache_exe_crc())
+	{
+		NX_LOG("bundle: '%s' is stale; it will be recorded again\n", fname);
+		free(file);
+		return 1;
+	}
+	
+	int data_start = BUNDLE_HEADER_SIZE + (nfiles * BUNDLE_INDEX_SIZE);
+	bool ok = (nfiles >= 0 && nfiles <= BUNDLE_MAX_FILES && data_start <= size);
+	
+	if (ok && crc_calc(file + BUNDLE_HEADER_SIZE, size - BUNDLE_HEADER_SIZE) != crc)
+		ok = false;
+	
+	// the files are packed one after the other
+	uint32_t packed_size = 0;
+	
+	for(int i=0;i<nfiles && ok;i++)
+	{
+		const uint8_t *entry = file + BUNDLE_HEADER_SIZE + (i * BUNDLE_INDEX_SIZE);
+		const uint8_t *eptr = entry + BUNDLE_NAME_LEN;
+		
+		uint32_t offset = read_U32(&eptr, end);
+		uint32_t length = read_U32(&eptr, end);
+		uint32_t packed = read_U32(&eptr, end);
+		uint32_t mtime = read_U32(&eptr, end);
+		uint32_t avail = (size - data_start);
+		
+		if (entry[BUNDLE_NAME_LEN - 1] != 0 || offset != packed_size || \
+			packed > length || packed > avail - packed_size || length > BUNDLE_MAX_LENGTH)
+		{
+			ok = false;
+		}
+		
+		packed_size += packed;
+		
+		// it's rebuilt if the file has been changed since, e.g. by a mod
+		if (ok && is_stale((const char *)entry, length, mtime))
+		{
+			NX_LOG("bundle: '%s' has changed since '%s' was written; it will be recorded again\n", \
+					(const char *)entry, fname);
+			free(file);
+			return 1;
+		}
+	}
+	
+	if (!ok)
+	{
+		NX_ERR("bundle: '%s' is corrupt; it will be recorded again\n", fname);
+		free(file);
+		return 1;
+	}
+	
+	bnd.file = file;
+	bnd.file_size = size;
+	bnd.nfiles = nfiles;
+	bnd.index = file + BUNDLE_HEADER_SIZE;
+	bnd.data = file + data_start;
+	
+	NX_LOG("bundle: loaded '%s'; %d files\n", fname, nfiles);
+	return 0;
+}
+
+static void free_bundle(void)
+{
+	if (bnd.file)
+		free(bnd.file);
+	
+	bnd.file = NULL;
+	bnd.index = bnd.data = NULL;
+	bnd.file_size = bnd.nfiles = 0;
+}
+
+// deletes the bundles of all stages, so that they'll be recorded again.
+// returns how many there were.
+int bundle_clear_all(void)
+{
+char fname[MAXPATHLEN];
+int count = 0;
+
+	bnd.recording = false;
+	bnd.rec_files.MakeEmpty();
+	free_bundle();
+	
+	for(int i=0;i<num_stages;i++)
+	{
+		if (!stages[i].filename[0])
+			continue;
+		
+		if (!get_bundle_name(i, fname) && !remove(fname))
+			count++;
+	}
+	
+	return count;
+}
+
+/*
+void c------------------------------() {}
+*/
+
+// the bundle for "data/Stage/Pens1.pxm" and co is "data/Stage/Pens1.nxb".
+// returns 1 if the path is too long.
+static bool get_bundle_name(int stage_no, char *buffer)
+{
+char slash;
+#ifdef _WIN32
+	slash = '\\';
+#else
+	slash = '/';
+#endif
+
+	if (snprintf(buffer, MAXPATHLEN, "%s%c%s%c%s" BUNDLE_EXTENSION, \
+			g_dir, slash, stage_dir, slash, stages[stage_no].filename) >= MAXPATHLEN)
+	{
+		NX_ERR("bundle: the path to the bundle of stage %d is too long\n", stage_no);
+		return 1;
+	}
+	
+	return 0;
+}
+
+// files are indexed by their path inside the data dir, so that bundles
+// still work if the whole thing is moved somewhere else.
+static const char *get_relative_name(const char *fname)
+{
+	int len = strlen(g_dir);
+	
+	if (!strncmp(fname, g_dir, len) && (fname[len] == '/' || fname[len] == '\\'))
+		return (fname + len + 1);
+	
+	return fname;
+}
+
+// returns true if the file with the given name in the data dir isn't the one
+// which was bundled, with the given size and modification time.
+static bool is_stale(const char *name, uint32_t size, uint32_t mtime)
+{
+char path[MAXPATHLEN];
+char slash;
+#ifdef _WIN32
+	slash = '\\';
+#else
+	slash = '/';
+#endif
+	uint32_t cur_size, cur_mtime;
+	
+	if (snprintf(path, sizeof(path), "%s%c%s", g_dir, slash, name) >= (int)sizeof(path))
+		return true;
+	
+	if (get_file_stamp(path, &cur_size, &cur_mtime))
+		return true;
+	
+	return (cur_size != size || cur_mtime != mtime);
+}
+
+// gets the size of a file on disk and when it was last modified.
+// returns 1 if it isn't there.
+static bool get_file_stamp(const char *fname, uint32_t *size_out, uint32_t *mtime_out)
+{
+#ifdef _XBOX1
+	// no stat here; only the size is checked
+	FILE *fp = fopen(fname, "rb");
+	if (!fp) return 1;
+	
+	*size_out = filesize(fp);
+	*mtime_out = 0;
+	fclose(fp);
+	return 0;
+#else
+	struct stat st;
+	if (stat(fname, &st))
+		return 1;
+	
+	*size_out = (uint32_t)st.st_size;
+	*mtime_out = (uint32_t)st.st_mtime;
+	return 0;
+#endif
+}
@@ -0,0 +1,47 @@
+
+#ifndef _BUNDLE_H
+#define _BUNDLE_H
+
+// a stage bundle packs every file a stage needs (the map, attributes, entities and
+// script, the tileset and backdrop, and the sprite sheets that were drawn from while
+// playing it) into one file next to the stage's own, so that entering the stage is
+// a single sequential read instead of a dozen opens and seeks. that matters a lot
+// on SD cards and network mounts.
+//
+// bundles are written into the data dir, so they're off unless turned on with the
+// "bundles on" console command (settings->stage_bundles). once they are, they're
+// recorded automatically: the first time a stage is visited, the files it uses are
+// noted, and the bundle is written as the stage is left. after that, anything
+// which is in the bundle is served from memory while on that stage.
+//
+// the files are stored compressed with the LZ codec in common/lz.cpp (unless they
+// don't get any smaller), so there's less to read. the bundle is kept in memory as
+// it was read, and each file is decompressed straight into the caller's buffer when
+// it's asked for.
+//
+// everything after the header is covered by a crc32, so a bundle which was damaged
+// on disk is recorded again instead of handing out garbage. so is one where any of
+// the files in it have changed since it was written (going by their size and when
+// they were last modified), e.g. because a mod was installed over the data dir.
+
+#define BUNDLE_MAGICK			'NXSB'
+#define BUNDLE_VERSION			5
+#define BUNDLE_EXTENSION		".nxb"
+
+#define BUNDLE_NAME_LEN			48			// of each filename in the index
+#define BUNDLE_MAX_FILES		64
+#define BUNDLE_MAX_LENGTH		(16 * 1024 * 1024)	// of any one file
+
+class DBuffer;
+
+void bundle_enter_stage(int stage_no);
+void bundle_close(void);
+
+bool bundle_read_file(const char *fname, DBuffer *out);
+
+int bundle_recording(void);
+void bundle_note(const char *fname);
+
+int bundle_clear_all(void);
+
+#endif
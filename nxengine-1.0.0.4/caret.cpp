@@ -102,7 +102,8 @@ int scr_x, scr_y;
 			// get caret's onscreen position
 			// since caret's are all short-lived we just assume it's still onscreen
 			// and let SDL's clipping handle it if not.
-			if (!c->invisible && !c->deleted)	// must check deleted again in case handler_function set it
+			if (!c->invisible && !c->deleted && 	// must check deleted again in case handler_function set it
+				!(caret_is_cosmetic(c) && Governor::Drop(c)))
 			{
 				scr_x = (c->x >> CSF) - (map.displayed_xscroll >> CSF);
 				scr_y = (c->y >> CSF) - (map.displayed_yscroll >> CSF);
@@ -117,6 +118,31 @@ int scr_x, scr_y;
 	}
 }
 
+// returns true if the caret is purely for show, and so can be left undrawn
+// by the governor when things are running slow. (the ones which tell the
+// player something, such as "Empty" or a level up, are always drawn).
+static bool caret_is_cosmetic(Caret *c)
+{
+	switch(c->effecttype)
+	{
+		case EFFECT_STARSOLID:
+		case EFFECT_STARPOOF:
+		case EFFECT_FISHY:
+		case EFFECT_BLOODSPLATTER:
+		case EFFECT_BONKPLUS:
+		case EFFECT_SMOKETRAIL:
+		case EFFECT_SMOKETRAIL_SLOW:
+		case EFFECT_GUNFISH_BUBBLE:
+		case EFFECT_LAVA_SPLASH:
+		case EFFECT_BUBBLE_BURST:
+		case EFFECT_SPUR_HIT:
+		case EFFECT_GHOST_SPARKLE:
+			return true;
+	}
+	
+	return false;
+}
+
 int Carets::CountByEffectType(int type)
 {
 	int count = 0;
@@ -130,6 +156,19 @@ int Carets::CountByEffectType(int type)
 	return count;
 }
 
+int Carets::CountAll(void)
+{
+	int count = 0;
+	Caret *c = firstcaret;
+	while(c)
+	{
+		count++;
+		c = c->next;
+	}
+	
+	return count;
+}
+
 int Carets::DeleteByEffectType(int type)
 {
 	int count = 0;
@@ -36,6 +36,7 @@ namespace Carets
 	
 	void DrawAll(void);
 	int CountByEffectType(int type);
+	int CountAll(void);
 	int DeleteByEffectType(int type);
 	void DestroyAll(void);
 };
@@ -172,3 +172,11 @@ int DBuffer::Length()
 	return fLength;
 }
 
+// resize the buffer to the given length without filling it in, so that it can be
+// written directly via Data(). any existing contents are kept up to the new length.
+void DBuffer::SetLength(int length)
+{
+	EnsureAlloc(length);
+	fLength = length;
+}
+
@@ -55,6 +55,7 @@ public:
 	uint8_t *TakeData();
 	char *String();
 	int Length();
+	void SetLength(int length);
 
 private:
 	uint8_t *fData;
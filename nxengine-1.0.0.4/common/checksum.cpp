@@ -0,0 +1,420 @@
+
+// checksums; see checksum.h.
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../nx.h"
+#include "checksum.h"
+
+#if (defined(__GNUC__) && (__GNUC__ >= 5 || defined(__clang__)) && \
+	 (defined(__i386__) || defined(__x86_64__))) || \
+	(defined(_MSC_VER) && _MSC_VER >= 1800 && (defined(_M_IX86) || defined(_M_X64)))
+	#define HAVE_CRC_PCLMUL
+	#include <immintrin.h>
+#endif
+
+#if defined(__ARM_FEATURE_CRC32) && !defined(__ARM_BIG_ENDIAN)
+	#define HAVE_CRC_ARMV8
+	#include <arm_acle.h>
+#endif
+
+#if defined(__GNUC__)
+	#define TARGET(isa)		__attribute__((target(isa)))
+#else
+	#define TARGET(isa)
+#endif
+
+#define CRC_POLY			0xedb88320		// 0x04c11db7, bit-reversed
+
+// the kernels work on the crc register as it is in the middle of a calculation,
+// that is, without the inversion which is done at the start and the end.
+typedef uint32_t (*CRCKernel)(uint32_t crc, const uint8_t *buf, uint32_t size);
+
+#include "checksum.fdh"
+
+// these are only there on some systems or builds, so they're not in the fdh
+#ifdef HAVE_CRC_PCLMUL
+static uint32_t crc_pclmul(uint32_t crc, const uint8_t *buf, uint32_t size);
+#endif
+#ifdef HAVE_CRC_ARMV8
+static uint32_t crc_armv8(uint32_t crc, const uint8_t *buf, uint32_t size);
+#endif
+#ifndef RELEASE_BUILD
+static int verify_paths(void);
+#endif
+
+static const char *path_names[] = { "slice1", "slice8", "pclmul", "armv8" };
+
+static uint32_t crc_table[8][256];
+static bool tables_built = false;
+
+static CRCKernel crc_kernel = NULL;
+static int crc_path = CRC_SLICE1;
+
+
+// builds the tables and picks the fastest path this CPU can do, unless
+// the NX_CRC environment variable names a particular one. it's done
+// automatically the first time a crc is taken.
+void crc_init(void)
+{
+	if (crc_kernel)
+		return;
+	
+	// the paths are in order of preference
+	int path = (CRC_NUM_PATHS - 1);
+	const char *override = getenv("NX_CRC");
+	
+	if (override)
+	{
+		for(int i=0;i<CRC_NUM_PATHS;i++)
+		{
+			if (!strcasecmp(override, path_names[i]))
+				path = i;
+		}
+	}
+	
+	while(crc_set_path(path))
+		path--;
+	
+	NX_LOG("crc_init: using the %s crc\n", path_names[crc_path]);
+
+#ifndef RELEASE_BUILD
+	if (verify_paths())
+		NX_ERR("crc_init: some crc paths don't match the reference!\n");
+#endif
+}
+
+// returns the crc32 of the given data
+uint32_t crc_calc(const void *buf, uint32_t size)
+{
+	return crc_update(0, buf, size);
+}
+
+// continues a crc32 which was started over some earlier data, returning the crc
+// of all of it together. start with a crc of 0.
+uint32_t crc_update(uint32_t crc, const void *buf, uint32_t size)
+{
+	if (!crc_kernel)
+		crc_init();
+	
+	uint32_t result = ~(*crc_kernel)(~crc, (const uint8_t *)buf, size);
+	
+	if (shadow_enabled && crc_path != CRC_SLICE1)
+	{
+		uint32_t ref = ~crc_slice1(~crc, (const uint8_t *)buf, size);
+		if (result != ref)
+		{
+			Shadow::Mismatch("crc32", "crc_update(0x%08x, %p, %u) gave 0x%08x on the %s path, not 0x%08x", \
+							crc, buf, size, result, path_names[crc_path], ref);
+		}
+	}
+	
+	return result;
+}
+
+/*
+void c------------------------------() {}
+*/
+
+int crc_get_path(void)
+{
+	if (!crc_kernel)
+		crc_init();
+	
+	return crc_path;
+}
+
+// switches to the given path. returns 1 if this CPU can't do it.
+bool crc_set_path(int path)
+{
+	CRCKernel kernel = get_kernel(path);
+	if (!kernel)
+		return 1;
+	
+	crc_kernel = kernel;
+	crc_path = path;
+	return 0;
+}
+
+const char *crc_path_name(int path)
+{
+	if (path < 0 || path >= CRC_NUM_PATHS)
+		return "none";
+	
+	return path_names[path];
+}
+
+// returns the kernel for the given path, or NULL if it's not available
+static CRCKernel get_kernel(int path)
+{
+	if (!tables_built)
+		build_tables();
+	
+	switch(path)
+	{
+		case CRC_SLICE1: return crc_slice1;
+		case CRC_SLICE8: return crc_slice8;
+	
+	#ifdef HAVE_CRC_PCLMUL
+		case CRC_PCLMUL:
+			if (SDL_HasPCLMUL() && SDL_HasSSE41())
+				return crc_pclmul;
+		break;
+	#endif
+	
+	#ifdef HAVE_CRC_ARMV8
+		case CRC_ARMV8: return crc_armv8;
+	#endif
+	}
+	
+	return NULL;
+}
+
+// crc_table[0] is the usual table; each of the others is the one before it
+// followed by another zero byte, so that bytes further back in a block of
+// 8 can be looked up all at once as if they had been run all the way through.
+static void build_tables(void)
+{
+	for(int i=0;i<256;i++)
+	{
+		uint32_t c = i;
+		for(int j=0;j<8;j++)
+			c = (c >> 1) ^ ((c & 1) ? CRC_POLY : 0);
+		
+		crc_table[0][i] = c;
+	}
+	
+	for(int t=1;t<8;t++)
+	{
+		for(int i=0;i<256;i++)
+		{
+			uint32_t c = crc_table[t - 1][i];
+			crc_table[t][i] = (c >> 8) ^ crc_table[0][c & 0xff];
+		}
+	}
+	
+	tables_built = true;
+}
+
+/*
+void c------------------------------() {}
+*/
+
+static uint32_t crc_slice1(uint32_t crc, const uint8_t *buf, uint32_t size)
+{
+	while(size--)
+		crc = (crc >> 8) ^ crc_table[0][(crc ^ *buf++) & 0xff];
+	
+	return crc;
+}
+
+// the words are put together a byte at a time so that it comes out the same on
+// big-endian systems; on little-endian ones the compiler makes them single loads.
+static uint32_t crc_slice8(uint32_t crc, const uint8_t *buf, uint32_t size)
+{
+	while(size >= 8)
+	{
+		uint32_t lo = crc ^ (buf[0] | (buf[1] << 8) | (buf[2] << 16) | ((uint32_t)buf[3] << 24));
+		uint32_t hi = (buf[4] | (buf[5] << 8) | (buf[6] << 16) | ((uint32_t)buf[7] << 24));
+		
+		crc = crc_table[7][lo & 0xff] ^ crc_table[6][(lo >> 8) & 0xff] ^ \
+			  crc_table[5][(lo >> 16) & 0xff] ^ crc_table[4][lo >> 24] ^ \
+			  crc_table[3][hi & 0xff] ^ crc_table[2][(hi >> 8) & 0xff] ^ \
+			  crc_table[1][(hi >> 16) & 0xff] ^ crc_table[0][hi >> 24];
+		
+		buf += 8;
+		size -= 8;
+	}
+	
+	return crc_slice1(crc, buf, size);
+}
+
+#ifdef HAVE_CRC_PCLMUL
+// folds 64 bytes at a time into four 128-bit accumulators by carry-less multiplying
+// them by x^n mod P, then folds those down and does a Barrett reduction to get the
+// crc. this is the method from Intel's paper "Fast CRC Computation for Generic
+// Polynomials Using PCLMULQDQ Instruction", with the constants for the bit-reflected
+// crc32. size must be at least 64 and a multiple of 16.
+static TARGET("pclmul,sse4.1") uint32_t crc_fold_pclmul(uint32_t crc, const uint8_t *buf, uint32_t size)
+{
+	const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596LL, 0x0154442bd4LL);
+	const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009eLL, 0x01751997d0LL);
+	const __m128i k5k0 = _mm_set_epi64x(0, 0x0163cd6124LL);
+	const __m128i poly = _mm_set_epi64x(0x01f7011641LL, 0x01db710641LL);
+	const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+	__m128i x1, x2, x3, x4, x5, x6, x7, x8;
+	
+	x1 = _mm_loadu_si128((const __m128i *)(buf + 0x00));
+	x2 = _mm_loadu_si128((const __m128i *)(buf + 0x10));
+	x3 = _mm_loadu_si128((const __m128i *)(buf + 0x20));
+	x4 = _mm_loadu_si128((const __m128i *)(buf + 0x30));
+	x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+	
+	buf += 64;
+	size -= 64;
+	
+	// fold 64 bytes at a time
+	while(size >= 64)
+	{
+		x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+		x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+		x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+		x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+		
+		x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+		x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+		x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+		x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+		
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i *)(buf + 0x00)));
+		x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i *)(buf + 0x10)));
+		x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i *)(buf + 0x20)));
+		x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i *)(buf + 0x30)));
+		
+		buf += 64;
+		size -= 64;
+	}
+	
+	// fold the four accumulators into one
+	x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+	
+	x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+	
+	x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+	
+	// then fold in whatever's left, 16 bytes at a time
+	while(size >= 16)
+	{
+		x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128((const __m128i *)buf)), x5);
+		
+		buf += 16;
+		size -= 16;
+	}
+	
+	// 128 bits down to 64
+	x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+	x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+	
+	x2 = _mm_srli_si128(x1, 4);
+	x1 = _mm_and_si128(x1, mask32);
+	x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+	
+	// Barrett reduction down to 32
+	x2 = _mm_and_si128(x1, mask32);
+	x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+	x2 = _mm_and_si128(x2, mask32);
+	x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+	
+	return (uint32_t)_mm_extract_epi32(x1, 1);
+}
+
+static uint32_t crc_pclmul(uint32_t crc, const uint8_t *buf, uint32_t size)
+{
+	if (size >= 64)
+	{
+		uint32_t chunk = (size & ~15);
+		
+		crc = crc_fold_pclmul(crc, buf, chunk);
+		buf += chunk;
+		size -= chunk;
+	}
+	
+	return crc_slice8(crc, buf, size);
+}
+#endif
+
+#ifdef HAVE_CRC_ARMV8
+static uint32_t crc_armv8(uint32_t crc, const uint8_t *buf, uint32_t size)
+{
+	while(size && ((uintptr_t)buf & 7))
+	{
+		crc = __crc32b(crc, *buf++);
+		size--;
+	}
+	
+	while(size >= 8)
+	{
+		uint64_t word;
+		memcpy(&word, buf, 8);
+		crc = __crc32d(crc, word);
+		
+		buf += 8;
+		size -= 8;
+	}
+	
+	while(size--)
+		crc = __crc32b(crc, *buf++);
+	
+	return crc;
+}
+#endif
+
+/*
+void c------------------------------() {}
+*/
+
+#ifndef RELEASE_BUILD
+// checks every path this CPU can do against slice-by-1, at all the sizes and
+// alignments which take them down different code paths. returns the number of
+// mismatches.
+static int verify_paths(void)
+{
+uint8_t data[600];
+uint32_t seed = 0x2545f491;
+int failures = 0;
+
+	for(int i=0;i<(int)sizeof(data);i++)
+	{
+		seed = (seed * 1103515245) + 12345;
+		data[i] = (seed >> 16);
+	}
+	
+	for(int path=CRC_SLICE8;path<CRC_NUM_PATHS;path++)
+	{
+		CRCKernel kernel = get_kernel(path);
+		if (!kernel) continue;
+		
+		for(int offs=0;offs<8;offs++)
+		for(int len=0;len+offs<=(int)sizeof(data);len+=(len < 160) ? 1 : 37)
+		{
+			uint32_t ref = crc_slice1(0x12345678, &data[offs], len);
+			if ((*kernel)(0x12345678, &data[offs], len) != ref)
+			{
+				NX_ERR("crc: %s path is wrong at length %d offset %d\n", path_names[path], len, offs);
+				failures++;
+				break;
+			}
+		}
+	}
+	
+	return failures;
+}
+#endif
+
+/*
+void c------------------------------() {}
+*/
+
+uint32_t fnv_hash(uint32_t hash, const void *data, int length)
+{
+	const uint8_t *ptr = (const uint8_t *)data;
+	
+	for(int i=0;i<length;i++)
+	{
+		hash ^= ptr[i];
+		hash *= FNV_PRIME;
+	}
+	
+	return hash;
+}
@@ -0,0 +1,47 @@
+
+#ifndef _CHECKSUM_H
+#define _CHECKSUM_H
+
+// checksums, for everything in the engine which needs to know if some data
+// is what it's supposed to be: the files extracted from the exe, the caches
+// made from them, and the digests of the game state taken during replays.
+//
+// crc32 is the standard (zlib/PNG) one, as the table of known-good CRCs for
+// the extracted files was made with it. it's done with whichever of these is
+// the fastest the CPU can run; they all give exactly the same result:
+//
+//	slice-by-1		the classic one byte at a time table lookup, kept as the reference
+//	slice-by-8		eight tables, eight bytes at a time; the portable default
+//	pclmul			carry-less multiply folding, on x86 with PCLMULQDQ and SSE4.1
+//	armv8			the CRC32 instructions, on ARM when the compiler targets them
+//
+// the SSE4.2 crc32 instruction isn't used, as it computes a different CRC
+// (Castagnoli's polynomial), which would match none of the known-good ones.
+//
+// fnv is a plain byte-wise hash, for digesting small bits of state where
+// setting up a crc isn't worth it.
+
+#define FNV_BASIS			0x811c9dc5
+#define FNV_PRIME			0x01000193
+
+enum CRCPaths
+{
+	CRC_SLICE1,
+	CRC_SLICE8,
+	CRC_PCLMUL,
+	CRC_ARMV8,
+	
+	CRC_NUM_PATHS
+};
+
+void crc_init(void);
+uint32_t crc_calc(const void *buf, uint32_t size);
+uint32_t crc_update(uint32_t crc, const void *buf, uint32_t size);
+
+int crc_get_path(void);
+bool crc_set_path(int path);
+const char *crc_path_name(int path);
+
+uint32_t fnv_hash(uint32_t hash, const void *data, int length);
+
+#endif
@@ -0,0 +1,173 @@
+
+#include <stdlib.h>
+#include <string.h>
+#include "DBuffer.h"
+
+#include "../nx.h"
+#include "lz.h"
+#include "lz.fdh"
+
+static inline uint32_t read_raw32(const uint8_t *ptr)
+{
+uint32_t value;
+	memcpy(&value, ptr, 4);
+	return value;
+}
+
+static inline int lz_hash(uint32_t value)
+{
+	return (value * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+// compresses srclen bytes from src, appending the result to out.
+// returns the number of bytes appended.
+int lz_compress(const uint8_t *src, int srclen, DBuffer *out)
+{
+int table[1 << LZ_HASH_BITS];
+int start = out->Length();
+int anchor = 0;
+int i = 0;
+
+	memset(table, 0xff, sizeof(table));
+	
+	while(i + LZ_MIN_MATCH <= srclen)
+	{
+		uint32_t value = read_raw32(&src[i]);
+		int h = lz_hash(value);
+		int cand = table[h];
+		table[h] = i;
+		
+		if (cand < 0 || (i - cand) > LZ_MAX_OFFSET || read_raw32(&src[cand]) != value)
+		{
+			i++;
+			continue;
+		}
+		
+		int len = LZ_MIN_MATCH;
+		while(i + len < srclen && src[cand + len] == src[i + len])
+			len++;
+		
+		put_sequence(out, &src[anchor], i - anchor, i - cand, len);
+		
+		i += len;
+		anchor = i;
+	}
+	
+	// whatever's left over goes out as literals
+	put_sequence(out, &src[anchor], srclen - anchor, 0, 0);
+	
+	return (out->Length() - start);
+}
+
+static void put_sequence(DBuffer *out, const uint8_t *literals, int nliterals, int offset, int len)
+{
+	int lit_code = (nliterals < 15) ? nliterals : 15;
+	int len_code = 0;
+	
+	if (len)
+	{
+		len -= LZ_MIN_MATCH;
+		len_code = (len < 15) ? len : 15;
+	}
+	
+	out->Append8((lit_code << 4) | len_code);
+	if (lit_code == 15) put_length(out, nliterals - 15);
+	
+	out->AppendData(literals, nliterals);
+	
+	if (offset)
+	{
+		out->Append8(offset & 0xff);
+		out->Append8(offset >> 8);
+		if (len_code == 15) put_length(out, len - 15);
+	}
+}
+
+static void put_length(DBuffer *out, int value)
+{
+	while(value >= 255)
+	{
+		out->Append8(255);
+		value -= 255;
+	}
+	
+	out->Append8(value);
+}
+
+/*
+void c------------------------------() {}
+*/
+
+// decompresses the srclen bytes at src straight into dst, which must be exactly
+// the size the data was before it was compressed. returns 1 if the data is bad.
+bool lz_decompress(const uint8_t *src, int srclen, uint8_t *dst, int dstlen)
+{
+const uint8_t *send = src + srclen;
+uint8_t *d = dst;
+uint8_t *dend = dst + dstlen;
+
+	while(src < send)
+	{
+		int token = *src++;
+		
+		int nliterals = (token >> 4);
+		if (nliterals == 15 && get_length(&src, send, &nliterals))
+			return 1;
+		
+		if (nliterals > (send - src) || nliterals > (dend - d))
+			return 1;
+		
+		memcpy(d, src, nliterals);
+		src += nliterals;
+		d += nliterals;
+		
+		// the last sequence has no match
+		if (src >= send)
+			break;
+		
+		if ((send - src) < 2)
+			return 1;
+		
+		int offset = src[0] | (src[1] << 8);
+		src += 2;
+		
+		int len = (token & 15);
+		if (len == 15 && get_length(&src, send, &len))
+			return 1;
+		
+		len += LZ_MIN_MATCH;
+		
+		if (offset == 0 || offset > (d - dst) || len > (dend - d))
+			return 1;
+		
+		const uint8_t *match = (d - offset);
+		if (offset >= len)
+		{
+			memcpy(d, match, len);
+			d += len;
+		}
+		else
+		{	// overlapping, as in a run
+			while(len--) *d++ = *match++;
+		}
+	}
+	
+	return (d != dend);
+}
+
+static bool get_length(const uint8_t **src, const uint8_t *send, int *value)
+{
+	int b;
+	
+	do
+	{
+		if (*src >= send || *value > (1 << 30))
+			return 1;
+		
+		b = *(*src)++;
+		*value += b;
+	}
+	while(b == 255);
+	
+	return 0;
+}
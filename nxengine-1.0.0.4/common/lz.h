@@ -0,0 +1,25 @@
+
+#ifndef _LZ_H
+#define _LZ_H
+
+// a small byte-oriented LZ77 codec, in the same spirit as LZ4. it's used for
+// data the engine writes out for itself, such as the stage bundles, where
+// what matters is reading fewer bytes off slow storage and decoding them
+// again a lot faster than they could have been read.
+//
+// the stream is a series of sequences, each of which is a token byte (the
+// number of literals in the top 4 bits, the match length - LZ_MIN_MATCH in the
+// bottom 4, either one continued in extra bytes if it's 15), the literals, and
+// a 16-bit little-endian offset back to where the match is copied from. the last
+// sequence has only literals.
+
+#define LZ_MIN_MATCH		4
+#define LZ_MAX_OFFSET		65535
+#define LZ_HASH_BITS		12
+
+class DBuffer;
+
+int lz_compress(const uint8_t *src, int srclen, DBuffer *out);
+bool lz_decompress(const uint8_t *src, int srclen, uint8_t *dst, int dstlen);
+
+#endif
@@ -309,6 +309,12 @@ void seedrand(uint32_t newseed)
 	seed = newseed;
 }
 
+// returns the current seed without advancing it
+uint32_t getrandseed(void)
+{
+	return seed;
+}
+
 /*
 void c------------------------------() {}
 */
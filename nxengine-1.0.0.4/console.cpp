@@ -1,6 +1,8 @@
 
 #include "nx.h"
 #include <stdarg.h>
+#include "sound/audiocheck.h"
+#include "verify.h"
 #include "console.fdh"
 
 #ifdef _WIN32
@@ -37,6 +39,14 @@ static CommandEntry commands[] =
 	"cre", __cre, 0, 0,
 	"reset", __reset, 0, 0,
 	"fps", __fps, 0, 1,
+	"soak", __soak, 0, 2,
+	"hitch", __hitch, 0, 1,
+	"log-level", __log_level, 0, 1,
+	"audio-check", __audio_check, 0, 2,
+	"bundles", __bundles, 0, 1,
+	"verify", __verify, 0, 2,
+	"shadow", __shadow, 0, 1,
+	"perf", __perf, 0, 1,
 	
 	"instant-quit", __set_iquit, 1, 1,
 	"no-quake-in-hell", __set_noquake, 1, 1,
@@ -44,6 +54,7 @@ static CommandEntry commands[] =
 	"emulate-bugs", __emulate_bugs, 1, 1,
 	"displayformat", __displayformat, 1, 1,
 	"skip-intro", __skip_intro, 1, 1,
+	"detail-budget", __detail_budget, 1, 1,
 	
 	"player->hide", __player_hide, 1, 1,
 	"player->inputs_locked", __player_inputs_locked, 1, 1,
@@ -877,6 +888,199 @@ extern int fps;
 	fps = 0;
 }
 
+// soak [warp [frames per stage] | replay <slot> | stop]
+static void __soak(StringList *args, int num)
+{
+	const char *mode = (args->CountItems() > 0) ? args->StringAt(0) : "";
+	int param = (args->CountItems() > 1) ? atoi(args->StringAt(1)) : 0;
+	
+	if (!strcasecmp(mode, "warp"))
+	{
+		if (!Soak::Start(SOAK_WARP, param))
+			Respond("soak: warping through stages");
+		else
+			Respond("soak: failed to start");
+	}
+	else if (!strcasecmp(mode, "replay"))
+	{
+		if (!Soak::Start(SOAK_REPLAY, param))
+			Respond("soak: looping replay %d", param);
+		else
+			Respond("soak: failed to start");
+	}
+	else if (!strcasecmp(mode, "stop"))
+	{
+		Soak::Stop();
+		Respond("soak: stopped");
+	}
+	else
+	{
+		Respond("soak: %s", Soak::IsRunning() ? "running" : "not running");
+	}
+}
+
+// hitch [usec | default | off | dump]
+// sets the frame time over which the hitch recorder dumps what led up to it,
+// or dumps it right now.
+static void __hitch(StringList *args, int num)
+{
+	const char *arg = (args->CountItems() > 0) ? args->StringAt(0) : "";
+	
+	if (!strcasecmp(arg, "dump"))
+	{
+		if (!Hitch::Dump("dumped from the console"))
+			Respond("hitch: dumped");
+		else
+			Respond("hitch: failed to dump");
+		
+		return;
+	}
+	
+	if (!strcasecmp(arg, "default"))
+		settings->hitch_budget = 0;
+	else if (!strcasecmp(arg, "off"))
+		settings->hitch_budget = -1;
+	else if (num > 0)
+		settings->hitch_budget = num;
+	
+	if (arg[0])
+		settings_save();
+	
+	if (Hitch::Budget())
+		Respond("hitch recorder: %d usec per frame", Hitch::Budget());
+	else
+		Respond("hitch recorder: won't dump");
+}
+
+// log-level [info | warn | error | off]
+static void __log_level(StringList *args, int num)
+{
+	static const char *level_names[] = { "info", "warn", "error", "off" };
+	const char *level = (args->CountItems() > 0) ? args->StringAt(0) : "";
+	
+	for(int i=0;i<=NXL_OFF;i++)
+	{
+		if (!strcasecmp(level, level_names[i]))
+			nx_log_set_level(i);
+	}
+	
+	Respond("log level: %s", level_names[nx_log_get_level()]);
+}
+
+// audio-check [off | on [tolerance] | record]
+// takes effect from the next replay played back.
+static void __audio_check(StringList *args, int num)
+{
+	static const char *mode_names[] = { "off", "on", "record" };
+	const char *mode = (args->CountItems() > 0) ? args->StringAt(0) : "";
+	int tolerance = (args->CountItems() > 1) ? atoi(args->StringAt(1)) : 0;
+	
+	for(int i=0;i<3;i++)
+	{
+		if (!strcasecmp(mode, mode_names[i]))
+			audiocheck_set_mode(i, tolerance);
+	}
+	
+	Respond("audio check: %s", mode_names[audiocheck_get_mode()]);
+}
+
+// bundles [on | off | clear]
+// clearing them has each stage's bundle recorded again on it's next visit.
+static void __bundles(StringList *args, int num)
+{
+	const char *arg = (args->CountItems() > 0) ? args->StringAt(0) : "";
+	
+	if (!strcasecmp(arg, "clear"))
+	{
+		Respond("bundles: removed %d", bundle_clear_all());
+		return;
+	}
+	
+	if (!strcasecmp(arg, "on"))
+		settings->stage_bundles = 1;
+	else if (!strcasecmp(arg, "off"))
+		settings->stage_bundles = 0;
+	
+	if (arg[0])
+		settings_save();
+	
+	Respond("stage bundles: %s", (settings->stage_bundles > 0) ? "on" : "off");
+}
+
+// verify [off | on | record [interval]]
+// takes effect from the next replay played back.
+static void __verify(StringList *args, int num)
+{
+	static const char *mode_names[] = { "off", "on", "record" };
+	const char *mode = (args->CountItems() > 0) ? args->StringAt(0) : "";
+	int interval = (args->CountItems() > 1) ? atoi(args->StringAt(1)) : 0;
+	
+	for(int i=0;i<3;i++)
+	{
+		if (!strcasecmp(mode, mode_names[i]))
+			Verify::SetMode(i, interval);
+	}
+	
+	Respond("verify: %s", mode_names[Verify::GetMode()]);
+}
+
+// shadow [on | off]
+// checks the kernels which have a reference version against it on every call;
+// the first mismatch of each is written to shadow.txt.
+static void __shadow(StringList *args, int num)
+{
+	const char *arg = (args->CountItems() > 0) ? args->StringAt(0) : "";
+	
+	if (!strcasecmp(arg, "on"))
+		Shadow::SetEnabled(true);
+	else if (!strcasecmp(arg, "off"))
+		Shadow::SetEnabled(false);
+	
+	if (shadow_enabled)
+		Respond("shadow: on, %d mismatches", Shadow::Mismatches());
+	else
+		Respond("shadow: off");
+}
+
+// perf [on | off | reset | dump]
+// reads the CPU's performance counters in each of the hitch recorder's zones;
+// dump writes the totals so far out to perf.txt.
+static void __perf(StringList *args, int num)
+{
+	const char *arg = (args->CountItems() > 0) ? args->StringAt(0) : "";
+	
+	if (!strcasecmp(arg, "on"))
+	{
+		if (PerfCount::SetEnabled(true))
+		{
+			Respond("perf: no counters; timing only");
+			return;
+		}
+	}
+	else if (!strcasecmp(arg, "off"))
+	{
+		PerfCount::SetEnabled(false);
+	}
+	else if (!strcasecmp(arg, "reset"))
+	{
+		PerfCount::Reset();
+	}
+	else if (!strcasecmp(arg, "dump"))
+	{
+		if (!PerfCount::Dump())
+			Respond("perf: dumped to %s", PERFCOUNT_FNAME);
+		else
+			Respond("perf: failed to dump");
+		
+		return;
+	}
+	
+	if (perf_enabled)
+		Respond("perf: on, %d of %d counters", PerfCount::NumCounters(), PC_NUM_COUNTERS);
+	else
+		Respond("perf: off");
+}
+
 /*
 void c------------------------------() {}
 */
@@ -924,6 +1128,19 @@ static void __skip_intro(StringList *args, int num)
 	Respond("skip_intro: %s", settings->skip_intro ? "enabled":"disabled");
 }
 
+// sets the frame time in usec over which the governor starts thinning
+// out cosmetic effects, or 0 to always draw everything.
+static void __detail_budget(StringList *args, int num)
+{
+	settings->detail_budget = (num > 0) ? num : 0;
+	settings_save();
+	
+	if (settings->detail_budget)
+		Respond("detail governor: %d usec per frame", settings->detail_budget);
+	else
+		Respond("detail governor: disabled");
+}
+
 /*
 void c------------------------------() {}
 */
@@ -16,6 +16,8 @@ void c------------------------------() {}
 
 bool Credits::Init()
 {
+	strip = NULL;
+	
 	if (script.OpenFile()) return 1;
 	if (bigimage.Init()) return 1;
 	Replay::end_record();
@@ -26,10 +28,19 @@ bool Credits::Init()
 	xoffset = 0;
 	roll_running = true;
 	
-	lines_out = lines_vis = 0;
+	lines_out = 0;
+	
+	// black is transparent: the font and the cast sprites never draw black pixels
+	strip = new NXSurface(SCREEN_WIDTH, CRED_STRIP_HEIGHT);
+	if (!strip->fSurface)
+	{
+		NX_ERR("Credits::Init: failed to allocate credits strip\n");
+		return 1;
+	}
 	
-	firstline = NULL;
-	lastline = NULL;
+	SDL_SetColorKey(strip->fSurface, SDL_SRCCOLORKEY, 0);
+	strip->Clear(0, 0, 0);
+	strip_cleared_y = CRED_STRIP_HEIGHT;
 	
 	return 0;
 }
@@ -37,6 +48,7 @@ bool Credits::Init()
 Credits::~Credits()
 {
 	script.CloseFile();
+	delete strip;
 }
 
 /*
@@ -93,20 +105,17 @@ CredCommand cmd;
 	{
 		case CC_TEXT:
 		{
-			CredLine *line = NewLine();
-			
-			maxcpy(line->text, cmd.text, sizeof(line->text));
-			line->image = cmd.parm;
-			line->x = xoffset;
-			line->y = spawn_y;
+			int x = xoffset;
 			
 			// the last line is supposed to be centered--slightly
 			// varying font sizes can lead to it being a little bit off
-			if (strstr(line->text, "The End"))
+			if (strstr(cmd.text, "The End"))
 			{
-				line->x = (SCREEN_WIDTH / 2) - (GetFontWidth(line->text, TEXT_SPACING) / 2);
+				x = (SCREEN_WIDTH / 2) - (GetFontWidth(cmd.text, TEXT_SPACING) / 2);
 			}
 			
+			RenderLine(cmd.text, cmd.parm, x, spawn_y);
+			
 			spawn_y += 1;
 			lines_out++;
 		}
@@ -180,80 +189,74 @@ bool tried_rewind = false;
 void c------------------------------() {}
 */
 
-bool Credits::DrawLine(CredLine *line)
+// render a line of text (and it's cast image, if any) into the strip
+// at roll position y. this happens only once per line, when it is spawned.
+void Credits::RenderLine(const char *text, int image, int x, int y)
 {
-	int x = line->x;
-	int y = SCREEN_Y(line->y);
-	if (y < -MARGIN) return true;	// line can be deleted now
+	int top = y;
+	int bottom = y + GetFontHeight();
 	
-	if (line->image)
+	if (image)
 	{
-		draw_sprite(x - 24, y - 8, SPR_CASTS, line->image);
-		//DrawBox(x, y, x+GetFontWidth(line->text, TEXT_SPACING), y+8,  56, 0, 0);
+		top = y - 8;
+		if (top + sprites[SPR_CASTS].h > bottom)
+			bottom = top + sprites[SPR_CASTS].h;
 	}
 	
-	//int font_draw(int x, int y, const char *string, int font_spacing)
-	//DrawRect(x, y, x+63, y+8, 128, 0, 0);
-	font_draw(x, y, line->text, TEXT_SPACING);
+	ClearStripTo(bottom);
 	
-	return false;
-}
-
-
-void Credits::Draw()
-{
-CredLine *line, *next;
-
-	line = firstline;
-	while(line)
+	// draw it a second time shifted by the strip height if it straddles
+	// the wrap point; clipping takes care of the rest.
+	int sy = y % CRED_STRIP_HEIGHT;
+	int copies[] = { sy, sy - CRED_STRIP_HEIGHT, sy + CRED_STRIP_HEIGHT };
+	
+	for(int i=0;i<3;i++)
 	{
-		next = line->next;
+		int cy = copies[i];
+		if (cy + (bottom - y) <= 0 || cy + (top - y) >= CRED_STRIP_HEIGHT)
+			continue;
 		
-		if (DrawLine(line))
-		{
-			RemoveLine(line);
-			delete line;
-		}
+		if (image)
+			Sprites::draw_sprite_to_surface(strip, x - 24, cy - 8, SPR_CASTS, image, 0);
 		
-		line = next;
+		font_draw_to_surface(strip, x, cy, text, TEXT_SPACING);
 	}
 }
 
-/*
-void c------------------------------() {}
-*/
-
-CredLine *Credits::NewLine()
+// blank the strip rows which will be reused for roll positions up to y.
+// the rows they wrap onto have long since scrolled off the top of the screen.
+void Credits::ClearStripTo(int y)
 {
-	return AddLine(new CredLine);
-}
-
-CredLine *Credits::AddLine(CredLine *line)
-{
-	line->prev = NULL;
-	line->next = firstline;
+	if (y - strip_cleared_y > CRED_STRIP_HEIGHT)
+		strip_cleared_y = (y - CRED_STRIP_HEIGHT);
 	
-	if (firstline)
-	{
-		firstline->prev = line;
-		firstline = line;
-	}
-	else
+	while(strip_cleared_y < y)
 	{
-		firstline = lastline = line;
+		int sy = strip_cleared_y % CRED_STRIP_HEIGHT;
+		int count = (CRED_STRIP_HEIGHT - sy);
+		if (count > y - strip_cleared_y) count = (y - strip_cleared_y);
+		
+		strip->FillRect(0, sy, SCREEN_WIDTH - 1, sy + (count - 1), 0, 0, 0);
+		strip_cleared_y += count;
 	}
-	
-	lines_vis++;
-	return line;
 }
 
-void Credits::RemoveLine(CredLine *line)
+// composite the visible window of the strip onto the screen. this is a
+// single blit, or two when the window wraps around the end of the strip.
+void Credits::Draw()
 {
-	if (line->next) line->next->prev = line->prev;
-	if (line->prev) line->prev->next = line->next;
-	if (line == firstline) firstline = firstline->next;
-	if (line == lastline) lastline = lastline->next;
-	lines_vis--;
+	// keep blanking ahead of the screen even when no lines are being spawned,
+	// such as during long blank spaces, so stale rows never wrap into view.
+	ClearStripTo((scroll_y >> CSF) + SCREEN_HEIGHT);
+	
+	int sy = (scroll_y >> CSF) % CRED_STRIP_HEIGHT;
+	int ht = (CRED_STRIP_HEIGHT - sy);
+	if (ht > SCREEN_HEIGHT) ht = SCREEN_HEIGHT;
+	
+	DrawSurface(strip, 0, 0, 0, sy, SCREEN_WIDTH, ht);
+	
+	if (ht < SCREEN_HEIGHT)
+		DrawSurface(strip, 0, ht, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT - ht);
 }
 
 /*
@@ -3,18 +3,12 @@
 #define _CREDITS_H
 
 #define MAX_BIGIMAGES		20
-#define CRED_MAX_TEXT		80
 #include "CredReader.h"
 
-// a currently displayed line of text
-struct CredLine
-{
-	char text[CRED_MAX_TEXT];
-	int image;
-	int x, y;
-	
-	CredLine *next, *prev;
-};
+// height of the ring strip the roll is pre-rendered into. it must cover the
+// screen, the spawn-ahead margin and the tallest cast sprite, with room to spare
+// so that rows being cleared for new lines are never still on-screen.
+#define CRED_STRIP_HEIGHT	512
 
 class BigImage
 {
@@ -46,12 +40,10 @@ private:
 	void RunNextCommand();
 	bool Jump(int label);
 	
-	CredLine *NewLine();
-	CredLine *AddLine(CredLine *line);
-	void RemoveLine(CredLine *line);
+	void RenderLine(const char *text, int image, int x, int y);
+	void ClearStripTo(int y);
 	
 	void Draw();
-	bool DrawLine(CredLine *line);
 	
 	
 	int spawn_y;		// position of next line relative to top of roll
@@ -63,11 +55,14 @@ private:
 	bool roll_running;
 	
 	
-	int lines_out;		// debug...
-	int lines_vis;		// ...counters
+	int lines_out;		// debug counter
+	
+	// lines are rendered once, as they are spawned, into a ring strip which is
+	// then scrolled by offset. roll Y coordinates map to strip rows modulo its height.
+	NXSurface *strip;
+	int strip_cleared_y;	// roll Y up to which the strip has been blanked for new lines
 	
 	CredReader script;
-	CredLine *firstline, *lastline;
 };
 
 
@@ -6,9 +6,11 @@
 #include <string.h>
 #include <sys/stat.h>
 #include "../common/basics.h"
+#include "../common/checksum.h"
 #include "../libretro/libretro_shared.h"
 #include "extractfiles.fdh"
 #include "../nx_logger.h"
+#include "../bootcache.h"
 
 #ifdef __MINGW32__
 	#include <direct.h>
@@ -125,6 +127,13 @@ bool first_crc_failure = true;
 		
 		NX_LOG("[ %s ]\n", outfilename);
 		
+		// on a warm boot the exe is known to be the same one these were
+		// extracted from last time, so don't bother writing them out again.
+		// the wavetable isn't written to a file and always has to be loaded.
+		if (bootcache_is_warm() && strcmp(files[i].filename, "wavetable.dat") != 0 && \
+			file_exists(outfilename))
+			continue;
+		
 		// initialize header if any
 		file = buffer;
 		length = files[i].length;
@@ -4,6 +4,7 @@
 #include <string.h>
 #include <sys/stat.h>
 #include "../common/basics.h"
+#include "../common/checksum.h"
 #include "../libretro/libretro_shared.h"
 #include "extractfiles.fdh"
 #include "../nx_logger.h"
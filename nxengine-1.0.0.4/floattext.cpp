@@ -139,6 +139,11 @@ int x, y, i;
 		break;
 	}
 	
+	// the governor can hide floattext when running slow, but it still
+	// has to keep counting down as normal above.
+	if (Governor::Level() >= DETAIL_MINIMAL)
+		return;
+	
 	// set the SDL clipping region to just above the hold point
 	// so it looks like it "rolls" away.
 	if (ft->state == FT_SCROLL_AWAY)
@@ -227,5 +232,24 @@ void FloatText::ResetAll(void)
 	}
 }
 
+// returns how many floattexts exist. if orphaned_out is given, it is set to
+// how many of those belong to objects which have already been destroyed.
+int FloatText::CountAll(int *orphaned_out)
+{
+	FloatText *ft = first;
+	int count = 0, orphaned = 0;
+	
+	while(ft)
+	{
+		count++;
+		if (ft->ObjectDestroyed) orphaned++;
+		
+		ft = ft->next;
+	}
+	
+	if (orphaned_out) *orphaned_out = orphaned;
+	return count;
+}
+
 
 
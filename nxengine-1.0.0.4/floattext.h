@@ -29,6 +29,7 @@ public:
 	static void DrawAll();
 	static void DeleteAll();
 	static void ResetAll(void);
+	static int CountAll(int *orphaned_out = NULL);
 	
 	bool ObjectDestroyed;
 
@@ -36,6 +36,16 @@ tickfunctions[] =
 Object *onscreen_objects[MAX_OBJECTS];
 int nOnscreenObjects;
 
+// snapshot of the scene behind the inventory and Map System; see DrawFrozenScene()
+static struct
+{
+	NXSurface *sfc;
+	bool valid;
+	
+	int curWeapon;
+	uint32_t equipmask;
+} snapshot;
+
 Game game;
 TextBox textbox;
 DebugConsole console;
@@ -132,6 +142,11 @@ void Game::close(void)
 	
 	Objects::DestroyAll(true);	// destroy all objects and player
 	FloatText::DeleteAll();
+	Triggers::Close();
+	
+	delete snapshot.sfc;
+	snapshot.sfc = NULL;
+	snapshot.valid = false;
 }
 
 /*
@@ -253,8 +268,6 @@ void c------------------------------() {}
 // standard in-game tick (as opposed to title-screen, inventory etc)
 void game_tick_normal(void)
 {
-Object *o;
-
 	player->riding = NULL;
 	player->bopped_object = NULL;
 	Objects::UpdateBlockStates();
@@ -267,17 +280,16 @@ Object *o;
 		
 		// now objects AI and move all objects to their new positions
 		Objects::RunAI();
+		
+		Hitch::BeginZone(HZ_PHYSICS);
 		Objects::PhysicsSim();
+		Hitch::EndZone(HZ_PHYSICS);
 		
 		// run the "aftermove" AI routines
 		HandlePlayer_am();
 		game.stageboss.RunAftermove();
 		
-		FOREACH_OBJECT(o)
-		{
-			if (!o->deleted)
-				o->OnAftermove();
-		}
+		Objects::RunAftermove();
 	}
 
 	// important to put this before and not after DrawScene(), or non-existant objects
@@ -337,8 +349,10 @@ int scr_x, scr_y;
 		AnimateMotionTiles();
 	
 	// draw background map tiles
+	Hitch::BeginZone(HZ_MAP_DRAW);
 		map_draw_backdrop();
 		map_draw(false);
+	Hitch::EndZone(HZ_MAP_DRAW);
 	
 	// draw all objects following their z-order
 	nOnscreenObjects = 0;
@@ -387,7 +401,9 @@ int scr_x, scr_y;
 				return;
 			}
 			
-			if (!o->invisible && o->sprite != SPR_NULL)
+			// smoke is the first thing to go if the governor says we're running slow
+			if (!o->invisible && o->sprite != SPR_NULL && \
+				!(o->type == OBJ_SMOKE_CLOUD && Governor::Drop(o)))
 			{
 				scr_x += o->display_xoff;
 				
@@ -411,7 +427,9 @@ int scr_x, scr_y;
 	DrawPlayer();
 	
 	// draw foreground map tiles
+	Hitch::BeginZone(HZ_MAP_DRAW);
    map_draw(TA_FOREGROUND);
+	Hitch::EndZone(HZ_MAP_DRAW);
 	
 	// draw carets (always-on-top effects such as boomflash)
 	Carets::DrawAll();
@@ -426,6 +444,46 @@ int scr_x, scr_y;
 	//if (game.debug.debugmode) DrawAttrPoints();
 }
 
+// draws the scene for modes such as the inventory, which go over the top of a
+// frozen world. since nothing in it moves, it's only really drawn the first time;
+// that's copied off, and after that the copy is put back up instead.
+// the player is the one thing that can change while they're up (switching guns,
+// or putting on the Mimiga Mask), so it's drawn again if he does.
+void DrawFrozenScene(void)
+{
+	if (snapshot.valid && snapshot.curWeapon == player->curWeapon && \
+		snapshot.equipmask == player->equipmask && \
+		snapshot.sfc->Width() == screen->Width() && snapshot.sfc->Height() == screen->Height())
+	{
+		DrawSurface(snapshot.sfc, 0, 0);
+		return;
+	}
+	
+	DrawScene();
+	
+	if (!snapshot.sfc || snapshot.sfc->Width() != screen->Width() || \
+		snapshot.sfc->Height() != screen->Height())
+	{
+		delete snapshot.sfc;
+		snapshot.sfc = new NXSurface(screen->Width(), screen->Height());
+		
+		// it's opaque, so it'll cover whatever was on the screen before
+		SDL_SetColorKey(snapshot.sfc->fSurface, 0, 0);
+	}
+	
+	snapshot.sfc->DrawSurface(screen, 0, 0);
+	snapshot.valid = true;
+	snapshot.curWeapon = player->curWeapon;
+	snapshot.equipmask = player->equipmask;
+}
+
+// discards the snapshot, so that the next DrawFrozenScene() will draw a fresh one.
+// called as the frozen modes are entered from the game proper.
+void ThawScene(void)
+{
+	snapshot.valid = false;
+}
+
 /*
 void c------------------------------() {}
 */
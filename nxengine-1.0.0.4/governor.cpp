@@ -0,0 +1,118 @@
+
+// the detail governor; see governor.h.
+
+#include "nx.h"
+#include "libretro/libretro_shared.h"
+#include "governor.fdh"
+
+#define GOV_AVG_SHIFT			3		// frame time is averaged over about 8 frames
+#define GOV_ENGAGE_FRAMES		25		// half a second over budget drops a level
+#define GOV_RESTORE_FRAMES		150		// three seconds under 3/4 budget restores one
+
+static struct
+{
+	int level;
+	
+	int64_t frame_start;
+	int avg_usec;			// moving average of the frame time, << GOV_AVG_SHIFT
+	
+	int over_count;			// consecutive frames over budget
+	int under_count;		// consecutive frames with plenty of headroom
+} gov;
+
+
+void Governor::Reset(void)
+{
+	if (gov.level != DETAIL_FULL)
+	{
+		NX_LOG("Governor: restored full detail\n");
+	}
+	
+	memset(&gov, 0, sizeof(gov));
+}
+
+/*
+void c------------------------------() {}
+*/
+
+void Governor::BeginFrame(void)
+{
+	if (settings->detail_budget > 0)
+		gov.frame_start = retro_get_usec();
+}
+
+void Governor::EndFrame(void)
+{
+	int budget = settings->detail_budget;
+	if (budget <= 0)
+	{
+		if (gov.level != DETAIL_FULL || gov.avg_usec)
+			Governor::Reset();
+		
+		return;
+	}
+	
+	int elapsed = (int)(retro_get_usec() - gov.frame_start);
+	if (elapsed < 0) elapsed = 0;
+	
+	gov.avg_usec += elapsed - (gov.avg_usec >> GOV_AVG_SHIFT);
+	int avg = (gov.avg_usec >> GOV_AVG_SHIFT);
+	
+	if (avg > budget)
+	{
+		gov.under_count = 0;
+		
+		if (++gov.over_count >= GOV_ENGAGE_FRAMES && gov.level < DETAIL_NUM_LEVELS - 1)
+		{
+			gov.level++;
+			gov.over_count = 0;
+			
+			NX_LOG("Governor: frame time %d usec is over the %d usec budget; "
+				   "cosmetic detail reduced to level %d\n", avg, budget, gov.level);
+		}
+	}
+	else
+	{
+		gov.over_count = 0;
+		
+		if (gov.level > DETAIL_FULL && avg < (budget * 3) / 4)
+		{
+			if (++gov.under_count >= GOV_RESTORE_FRAMES)
+			{
+				gov.level--;
+				gov.under_count = 0;
+				
+				NX_LOG("Governor: frame time %d usec is back under budget; "
+					   "cosmetic detail raised to level %d\n", avg, gov.level);
+			}
+		}
+		else
+		{
+			gov.under_count = 0;
+		}
+	}
+}
+
+/*
+void c------------------------------() {}
+*/
+
+int Governor::Level(void)
+{
+	return gov.level;
+}
+
+// returns true if the given cosmetic item (smoke object, caret etc) should be
+// left undrawn this frame. the choice is made from the item's address, so that
+// the same ones are consistently dropped from frame to frame rather than flickering.
+bool Governor::Drop(const void *item)
+{
+	if (gov.level == DETAIL_FULL)
+		return false;
+	
+	uint32_t hash = (uint32_t)((size_t)item >> 4) * 2654435761U;
+	uint32_t mask = (1 << gov.level) - 1;
+	
+	return ((hash >> 16) & mask) != 0;
+}
+
@@ -0,0 +1,35 @@
+
+#ifndef _GOVERNOR_H
+#define _GOVERNOR_H
+
+// the detail governor is an opt-in safety valve for slow devices. it times how long
+// each frame takes to tick and draw, and if that stays over budget it starts thinning
+// out purely cosmetic effects (smoke, particle carets, floattext and the starflash),
+// bringing them back once there's headroom again.
+//
+// it only ever changes what gets drawn, never what gets simulated: thinned-out smoke
+// still exists and runs it's AI, floattext still counts, etc. so the game plays out
+// identically, and replays stay in sync, whatever detail level it's at.
+
+enum DetailLevels
+{
+	DETAIL_FULL = 0,		// everything is drawn
+	DETAIL_REDUCED,			// half of all smoke and particle carets
+	DETAIL_LOW,				// a quarter of them, and no starflash
+	DETAIL_MINIMAL,			// an eighth of them, and no floattext
+	
+	DETAIL_NUM_LEVELS
+};
+
+namespace Governor
+{
+	void Reset(void);
+	
+	void BeginFrame(void);
+	void EndFrame(void);
+	
+	int Level(void);
+	bool Drop(const void *item);
+};
+
+#endif
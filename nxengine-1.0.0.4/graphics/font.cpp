@@ -366,6 +366,19 @@ int font_draw(int x, int y, const char *text, int spacing, NXFont *font)
 	return (text_draw(x, y, text, spacing, font));
 }
 
+// draw a text string onto some surface other than the screen
+int font_draw_to_surface(NXSurface *dst, int x, int y, const char *text, int spacing, NXFont *font)
+{
+	SDL_Surface *oldtarget = sdl_screen;
+	int wd;
+
+	sdl_screen = dst->fSurface;
+	wd = text_draw(x, y, text, spacing, font);
+	sdl_screen = oldtarget;
+
+	return (wd);
+}
+
 // draw a text string with a 50% dark border around it
 int font_draw_shaded(int x, int y, const char *text, int spacing, NXFont *font)
 {
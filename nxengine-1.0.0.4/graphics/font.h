@@ -27,6 +27,7 @@ extern NXFont shadowfont;	// white letters w/ drop shadow
 bool font_init(void);
 void font_close(void);
 int font_draw(int x, int y, const char *text, int spacing=0, NXFont *font=&whitefont);
+int font_draw_to_surface(NXSurface *dst, int x, int y, const char *text, int spacing=0, NXFont *font=&whitefont);
 int font_draw_shaded(int x, int y, const char *text, int spacing=0, NXFont *font=&whitefont);
 
 int GetFontWidth(const char *text, int spacing=0, bool is_shaded=false);
@@ -2,18 +2,21 @@
 // graphics routines
 #include <SDL.h>
 #include <SDL_getenv.h>
+#include <SDL_simd.h>
 
 #include <stdlib.h>
 #include "../config.h"
 #include "graphics.h"
 #include "tileset.h"
 #include "sprites.h"
+#include "lowres.h"
 #include "../dirnames.h"
 #include "../nx.h"
 #include "graphics.fdh"
 
 NXSurface *screen = NULL;				// created from SDL's screen
 static NXSurface *drawtarget = NULL;	// target of DrawRect etc; almost always screen
+static bool drawing = true;				// false to leave the screen alone; see SetDrawing
 int screen_bpp;
 
 const NXColor DK_BLUE(0, 0, 0x21);		// the popular dk blue backdrop color
@@ -27,7 +30,18 @@ bool Graphics::init(int resolution)
 	screen_bpp = 16;	// the default
 
 	const SDL_VideoInfo *info;
-
+	
+	// pick the blit/fill/mix kernels now, rather than in the middle of the first frame
+	SDL_GetSIMDPath();
+	
+#ifndef RELEASE_BUILD
+	SDL_SIMDPath path = SDL_GetSIMDPath();
+	NX_LOG("Graphics::init: using %s kernels\n", SDL_GetSIMDPathName(path));
+	
+	if (SDL_VerifySIMDKernels(path))
+		NX_ERR("Graphics::init: %s kernels don't match the scalar ones!\n", SDL_GetSIMDPathName(path));
+#endif
+	
 	if (SetResolution(resolution, false))
 		return 1;
 	
@@ -200,6 +214,12 @@ void c------------------------------() {}
 // draw the entire surface to the screen at the given coordinates.
 void Graphics::DrawSurface(NXSurface *src, int x, int y)
 {
+	if (!drawing && drawtarget == screen)
+	{
+		LowRes::DrawSurface(src, x, y, 0, 0, src->Width(), src->Height());
+		return;
+	}
+	
 	drawtarget->DrawSurface(src, x, y);
 }
 
@@ -208,6 +228,12 @@ void Graphics::DrawSurface(NXSurface *src, int x, int y)
 void Graphics::DrawSurface(NXSurface *src, \
 						   int dstx, int dsty, int srcx, int srcy, int wd, int ht)
 {
+	if (!drawing && drawtarget == screen)
+	{
+		LowRes::DrawSurface(src, dstx, dsty, srcx, srcy, wd, ht);
+		return;
+	}
+	
 	drawtarget->DrawSurface(src, dstx, dsty, srcx, srcy, wd, ht);
 }
 
@@ -215,6 +241,12 @@ void Graphics::DrawSurface(NXSurface *src, \
 // blit the specified surface across the screen in a repeating pattern
 void Graphics::BlitPatternAcross(NXSurface *sfc, int x_dst, int y_dst, int y_src, int height)
 {
+	if (!drawing && drawtarget == screen)
+	{
+		LowRes::BlitPatternAcross(sfc, x_dst, y_dst, y_src, height);
+		return;
+	}
+	
 	drawtarget->BlitPatternAcross(sfc, x_dst, y_dst, y_src, height);
 }
 
@@ -224,21 +256,45 @@ void c------------------------------() {}
 
 void Graphics::DrawRect(int x1, int y1, int x2, int y2, NXColor color)
 {
+	if (!drawing && drawtarget == screen)
+	{
+		draw_lowres_rect(x1, y1, x2, y2, color.r, color.g, color.b);
+		return;
+	}
+	
 	drawtarget->DrawRect(x1, y1, x2, y2, color);
 }
 
 void Graphics::FillRect(int x1, int y1, int x2, int y2, NXColor color)
 {
+	if (!drawing && drawtarget == screen)
+	{
+		LowRes::FillRect(x1, y1, x2, y2, color.r, color.g, color.b);
+		return;
+	}
+	
 	drawtarget->FillRect(x1, y1, x2, y2, color);
 }
 
 void Graphics::DrawPixel(int x, int y, NXColor color)
 {
+	if (!drawing && drawtarget == screen)
+	{
+		LowRes::FillRect(x, y, x, y, color.r, color.g, color.b);
+		return;
+	}
+	
 	drawtarget->DrawPixel(x, y, color);
 }
 
 void Graphics::ClearScreen(NXColor color)
 {
+	if (!drawing && drawtarget == screen)
+	{
+		LowRes::Clear(color.r, color.g, color.b);
+		return;
+	}
+	
 	drawtarget->Clear(color.r, color.g, color.b);
 }
 
@@ -248,21 +304,45 @@ void c------------------------------() {}
 
 void Graphics::DrawRect(int x1, int y1, int x2, int y2, uint8_t r, uint8_t g, uint8_t b)
 {
+	if (!drawing && drawtarget == screen)
+	{
+		draw_lowres_rect(x1, y1, x2, y2, r, g, b);
+		return;
+	}
+	
 	drawtarget->DrawRect(x1, y1, x2, y2, r, g, b);
 }
 
 void Graphics::FillRect(int x1, int y1, int x2, int y2, uint8_t r, uint8_t g, uint8_t b)
 {
+	if (!drawing && drawtarget == screen)
+	{
+		LowRes::FillRect(x1, y1, x2, y2, r, g, b);
+		return;
+	}
+	
 	drawtarget->FillRect(x1, y1, x2, y2, r, g, b);
 }
 
 void Graphics::DrawPixel(int x, int y, uint8_t r, uint8_t g, uint8_t b)
 {
+	if (!drawing && drawtarget == screen)
+	{
+		LowRes::FillRect(x, y, x, y, r, g, b);
+		return;
+	}
+	
 	drawtarget->DrawPixel(x, y, r, g, b);
 }
 
 void Graphics::ClearScreen(uint8_t r, uint8_t g, uint8_t b)
 {
+	if (!drawing && drawtarget == screen)
+	{
+		LowRes::Clear(r, g, b);
+		return;
+	}
+	
 	drawtarget->Clear(r, g, b);
 }
 
@@ -272,19 +352,31 @@ void c------------------------------() {}
 
 void Graphics::set_clip_rect(int x, int y, int w, int h)
 {
+	if (drawtarget == screen) LowRes::set_clip_rect(x, y, w, h);
 	drawtarget->set_clip_rect(x, y, w, h);
 }
 
 void Graphics::set_clip_rect(NXRect *rect)
 {
+	if (drawtarget == screen) LowRes::set_clip_rect(rect->x, rect->y, rect->w, rect->h);
 	drawtarget->set_clip_rect(rect);
 }
 
 void Graphics::clear_clip_rect()
 {
+	if (drawtarget == screen) LowRes::clear_clip_rect();
 	drawtarget->clear_clip_rect();
 }
 
+// the outline of a rectangle, as NXSurface::DrawRect does it
+static void draw_lowres_rect(int x1, int y1, int x2, int y2, uint8_t r, uint8_t g, uint8_t b)
+{
+	LowRes::FillRect(x1, y1, x2, y1, r, g, b);
+	LowRes::FillRect(x1, y2, x2, y2, r, g, b);
+	LowRes::FillRect(x1, y1, x1, y2, r, g, b);
+	LowRes::FillRect(x2, y1, x2, y2, r, g, b);
+}
+
 /*
 void c------------------------------() {}
 */
@@ -296,6 +388,23 @@ void Graphics::SetDrawTarget(NXSurface *surface)
 	drawtarget = surface;
 }
 
+// turns drawing to the screen on or off. with it off, the game is still drawn
+// in the sense that everything runs through its draw code (some things are
+// worked out there, such as which objects are onscreen), but none of it
+// actually touches the screen, which is left as it was. used when running
+// the game headless, where no-one is going to see the frames.
+// anything which would have been drawn to the screen goes to the low-res
+// target instead, if there is one; see lowres.h.
+void Graphics::SetDrawing(bool enable)
+{
+	drawing = enable;
+}
+
+bool Graphics::IsDrawing()
+{
+	return drawing;
+}
+
 
 
 
@@ -56,6 +56,9 @@ namespace Graphics
 	void clear_clip_rect();
 	
 	void SetDrawTarget(NXSurface *surface);
+	
+	void SetDrawing(bool enable);
+	bool IsDrawing();
 };
 
 #endif
@@ -0,0 +1,287 @@
+
+// low-resolution rendering; see lowres.h.
+
+#include <SDL.h>
+#include "../nx.h"
+#include "lowres.h"
+#include "lowres.fdh"
+
+// palettes of 8-bit surfaces converted to brightnesses, so the sprite sheets
+// and tileset don't have to be converted over again each time they're drawn
+#define PAL_CACHE_SIZE		8
+
+static struct
+{
+	uint8_t *pixels;		// NULL if not active
+	int shift;
+	int width, height;		// of the target
+	
+	// clip rect, in screen coordinates (x2/y2 exclusive)
+	int clipx1, clipy1, clipx2, clipy2;
+	
+	uint8_t *luma16;		// brightness of each 16-bit pixel value in the screen's format
+	
+	struct
+	{
+		SDL_Palette *palette;
+		uint8_t luma[256];
+	} palcache[PAL_CACHE_SIZE];
+	int palcache_next;
+} lr;
+
+
+// sets the buffer to draw into, which must be LOWRES_WIDTH(shift) * LOWRES_HEIGHT(shift)
+// bytes, or NULL to stop drawing into one. returns 1 if the shift isn't supported.
+bool LowRes::SetTarget(uint8_t *pixels, int shift)
+{
+	if (shift < 0 || shift > LOWRES_MAX_SHIFT)
+	{
+		NX_ERR("LowRes::SetTarget: shift %d is out of range\n", shift);
+		return 1;
+	}
+	
+	if (pixels && !lr.luma16)
+		make_luma16();
+	
+	lr.pixels = pixels;
+	lr.shift = shift;
+	lr.width = LOWRES_WIDTH(shift);
+	lr.height = LOWRES_HEIGHT(shift);
+	clear_clip_rect();
+	
+	// a sheet may have been reloaded since, with its palette at the same address
+	memset(lr.palcache, 0, sizeof(lr.palcache));
+	lr.palcache_next = 0;
+	return 0;
+}
+
+bool LowRes::IsActive()
+{
+	return (lr.pixels != NULL);
+}
+
+/*
+void c------------------------------() {}
+*/
+
+// draws part of a surface, sampling it only where it lands on the top-left
+// pixel of one of the target's blocks.
+void LowRes::DrawSurface(NXSurface *src, int dstx, int dsty, int srcx, int srcy, int wd, int ht)
+{
+SDL_Surface *sfc = src->fSurface;
+const uint8_t *luma;
+uint32_t key;
+int bpp;
+
+	if (!lr.pixels || !sfc)
+		return;
+	
+	bpp = sfc->format->BytesPerPixel;
+	if (bpp == 1)
+	{
+		luma = palette_luma(sfc->format->palette);
+		if (!luma) return;
+	}
+	else if (bpp == 2)
+	{
+		luma = lr.luma16;
+	}
+	else
+	{
+		return;
+	}
+	
+	// nothing is drawn where the source has its colorkey
+	key = (sfc->flags & SDL_SRCCOLORKEY) ? sfc->format->colorkey : 0xffffffff;
+	
+	// clip the source to the surface, then the destination to the clip rect
+	if (srcx < 0) { dstx -= srcx; wd += srcx; srcx = 0; }
+	if (srcy < 0) { dsty -= srcy; ht += srcy; srcy = 0; }
+	if (srcx + wd > sfc->w) wd = (sfc->w - srcx);
+	if (srcy + ht > sfc->h) ht = (sfc->h - srcy);
+	
+	int x1 = MAX(dstx, lr.clipx1);
+	int y1 = MAX(dsty, lr.clipy1);
+	int x2 = MIN(dstx + wd, lr.clipx2);
+	int y2 = MIN(dsty + ht, lr.clipy2);
+	
+	// the target pixels whose top-left screen pixels are within that
+	int ox1, oy1, ox2, oy2;
+	if (!block_range(x1, x2, &ox1, &ox2) || !block_range(y1, y2, &oy1, &oy2))
+		return;
+	
+	int step = (1 << lr.shift);
+	int sx1 = srcx + ((ox1 << lr.shift) - dstx);
+	int sy = srcy + ((oy1 << lr.shift) - dsty);
+	
+	for(int oy=oy1;oy<oy2;oy++)
+	{
+		const uint8_t *srcline = (const uint8_t *)sfc->pixels + (sy * sfc->pitch);
+		uint8_t *out = &lr.pixels[(oy * lr.width) + ox1];
+		int sx = sx1;
+		
+		if (bpp == 1)
+		{
+			for(int ox=ox1;ox<ox2;ox++)
+			{
+				uint8_t c = srcline[sx];
+				if (c != key) *out = luma[c];
+				
+				out++;
+				sx += step;
+			}
+		}
+		else
+		{
+			const uint16_t *srcline16 = (const uint16_t *)srcline;
+			
+			for(int ox=ox1;ox<ox2;ox++)
+			{
+				uint16_t c = srcline16[sx];
+				if (c != key) *out = luma[c];
+				
+				out++;
+				sx += step;
+			}
+		}
+		
+		sy += step;
+	}
+}
+
+// as NXSurface::BlitPatternAcross
+void LowRes::BlitPatternAcross(NXSurface *src, int x_dst, int y_dst, int y_src, int height)
+{
+	if (!lr.pixels || !src->fSurface)
+		return;
+	
+	int wd = src->fSurface->w;
+	if (wd <= 0)
+		return;
+	
+	int x = x_dst;
+	do
+	{
+		DrawSurface(src, x, y_dst, 0, y_src, wd, height);
+		x += wd;
+	}
+	while(x < SCREEN_WIDTH);
+}
+
+// fills the inclusive rectangle, with a color given the same way as to NXSurface::FillRect
+void LowRes::FillRect(int x1, int y1, int x2, int y2, uint8_t r, uint8_t g, uint8_t b)
+{
+	if (!lr.pixels)
+		return;
+	
+	SDL_PixelFormat *format = screen->Format();
+	uint32_t pixel = ((r << format->Rshift) | (g << format->Gshift) | (b << format->Bshift));
+	
+	fill(x1, y1, x2 + 1, y2 + 1, lr.luma16[pixel & 0xffff]);
+}
+
+void LowRes::Clear(uint8_t r, uint8_t g, uint8_t b)
+{
+	if (!lr.pixels)
+		return;
+	
+	uint32_t pixel = SDL_MapRGB(screen->Format(), r, g, b);
+	fill(lr.clipx1, lr.clipy1, lr.clipx2, lr.clipy2, lr.luma16[pixel & 0xffff]);
+}
+
+// fills the target pixels whose top-left screen pixels are in [x1,x2) x [y1,y2)
+static void fill(int x1, int y1, int x2, int y2, uint8_t luma)
+{
+int ox1, oy1, ox2, oy2;
+
+	x1 = MAX(x1, lr.clipx1); x2 = MIN(x2, lr.clipx2);
+	y1 = MAX(y1, lr.clipy1); y2 = MIN(y2, lr.clipy2);
+	
+	if (!block_range(x1, x2, &ox1, &ox2) || !block_range(y1, y2, &oy1, &oy2))
+		return;
+	
+	for(int oy=oy1;oy<oy2;oy++)
+		memset(&lr.pixels[(oy * lr.width) + ox1], luma, (ox2 - ox1));
+}
+
+// gives the range of target pixels [*o1,*o2) whose top-left screen pixels fall
+// within the screen range [x1,x2). returns false if there aren't any.
+static bool block_range(int x1, int x2, int *o1, int *o2)
+{
+	int mask = (1 << lr.shift) - 1;
+	
+	*o1 = (x1 + mask) >> lr.shift;
+	*o2 = (x2 + mask) >> lr.shift;
+	return (*o2 > *o1);
+}
+
+/*
+void c------------------------------() {}
+*/
+
+void LowRes::set_clip_rect(int x, int y, int w, int h)
+{
+	lr.clipx1 = MAX(x, 0);
+	lr.clipy1 = MAX(y, 0);
+	lr.clipx2 = MIN(x + w, SCREEN_WIDTH);
+	lr.clipy2 = MIN(y + h, SCREEN_HEIGHT);
+}
+
+void LowRes::clear_clip_rect()
+{
+	set_clip_rect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+}
+
+/*
+void c------------------------------() {}
+*/
+
+// the brightness of a color, with the usual weights for how bright each part looks
+static uint8_t rgb_luma(uint8_t r, uint8_t g, uint8_t b)
+{
+	return ((r * 77) + (g * 150) + (b * 29)) >> 8;
+}
+
+static void make_luma16(void)
+{
+	SDL_PixelFormat *format = screen->Format();
+	uint8_t r, g, b;
+	
+	lr.luma16 = (uint8_t *)malloc(65536);
+	for(int i=0;i<65536;i++)
+	{
+		SDL_GetRGB(i, format, &r, &g, &b);
+		lr.luma16[i] = rgb_luma(r, g, b);
+	}
+}
+
+static const uint8_t *palette_luma(SDL_Palette *palette)
+{
+	int i;
+	
+	if (!palette)
+		return NULL;
+	
+	for(i=0;i<PAL_CACHE_SIZE;i++)
+	{
+		if (lr.palcache[i].palette == palette)
+			return lr.palcache[i].luma;
+	}
+	
+	i = lr.palcache_next;
+	lr.palcache_next = (lr.palcache_next + 1) % PAL_CACHE_SIZE;
+	
+	lr.palcache[i].palette = palette;
+	memset(lr.palcache[i].luma, 0, 256);
+	
+	// go through the screen's format, so that they come out exactly as
+	// bright as they would once they'd been blitted to it
+	for(int c=0;c<palette->ncolors && c<256;c++)
+	{
+		SDL_Color *color = &palette->colors[c];
+		uint32_t pixel = SDL_MapRGB(screen->Format(), color->r, color->g, color->b);
+		lr.palcache[i].luma[c] = lr.luma16[pixel & 0xffff];
+	}
+	
+	return lr.palcache[i].luma;
+}
@@ -0,0 +1,35 @@
+
+#ifndef _LOWRES_H
+#define _LOWRES_H
+
+// a low-resolution grayscale rendering of the screen, for agents which learn from
+// pixels. they'd otherwise take the full 320x240 frame and shrink it down, which
+// throws away nearly all the work that went into drawing it; instead, while the
+// screen itself isn't being drawn (Graphics::SetDrawing(false)), everything that
+// would have gone to it is drawn straight into a smaller 8-bit buffer.
+//
+// the buffer is the screen's size shifted down by "shift" (0-3), so e.g. a shift
+// of 2 gives 80x60. each of its pixels is the brightness of the screen pixel at
+// the top-left of the block it covers; the source art is sampled at just those
+// points, so drawing a 16x16 tile at a shift of 2 only reads 16 of its pixels.
+
+#define LOWRES_MAX_SHIFT		3
+
+#define LOWRES_WIDTH(shift)		(SCREEN_WIDTH >> (shift))
+#define LOWRES_HEIGHT(shift)	(SCREEN_HEIGHT >> (shift))
+
+namespace LowRes
+{
+	bool SetTarget(uint8_t *pixels, int shift);
+	bool IsActive();
+	
+	void DrawSurface(NXSurface *src, int dstx, int dsty, int srcx, int srcy, int wd, int ht);
+	void BlitPatternAcross(NXSurface *src, int x_dst, int y_dst, int y_src, int height);
+	void FillRect(int x1, int y1, int x2, int y2, uint8_t r, uint8_t g, uint8_t b);
+	void Clear(uint8_t r, uint8_t g, uint8_t b);
+	
+	void set_clip_rect(int x, int y, int w, int h);
+	void clear_clip_rect();
+};
+
+#endif
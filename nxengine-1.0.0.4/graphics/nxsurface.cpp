@@ -77,7 +77,11 @@ bool NXSurface::LoadImage(const char *pbm_name, bool use_colorkey)
 {
 	Free();
 
-	fSurface = SDL_LoadBMP(pbm_name);
+	// while on a stage, it's likely to be in that stage's bundle
+	DBuffer file;
+	if (!bundle_read_file(pbm_name, &file))
+		fSurface = SDL_LoadBMP_RW(SDL_RWFromMem(file.Data(), file.Length()), 1);
+	
 	if (!fSurface)
 	{
 		NX_ERR("NXSurface::LoadImage: load failed of '%s'!\n", pbm_name);
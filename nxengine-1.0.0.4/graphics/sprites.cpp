@@ -21,9 +21,11 @@ using namespace Graphics;
 static NXSurface *spritesheet[MAX_SPRITESHEETS];
 static int num_spritesheets;
 static StringList sheetfiles;
+static int sheet_noted[MAX_SPRITESHEETS];	// bundle_recording() when last noted
 
 SIFSprite sprites[MAX_SPRITES];
 int num_sprites;
+uint32_t sprites_geom_gen;
 
 
 bool Sprites::Init()
@@ -59,6 +61,20 @@ void Sprites::FlushSheets()
 	}
 }
 
+// returns how many sprite sheets are currently loaded
+int Sprites::CountLoadedSheets()
+{
+	int count = 0;
+	
+	for(int i=0;i<MAX_SPRITESHEETS;i++)
+	{
+		if (spritesheet[i])
+			count++;
+	}
+	
+	return count;
+}
+
 /*
 void c------------------------------() {}
 */
@@ -68,17 +84,10 @@ static void Sprites::LoadSheetIfNeeded(int sheetno)
 {
 	if (!spritesheet[sheetno])
 	{
-                char pbm_name[1024];
-		retro_create_subpath_string(pbm_name, sizeof(pbm_name), g_dir, data_dir, sheetfiles.StringAt(sheetno));
+		char pbm_name[1024];
+		get_sheet_path(sheetno, pbm_name, sizeof(pbm_name));
 		NX_LOG("LoadSheetIfNeeded: %s\n", pbm_name);
-
-#ifdef _WIN32
-      for (unsigned i = 0; i < sizeof(pbm_name); i++)
-      {
-         if (pbm_name[i] == '/')
-            pbm_name[i] = '\\';
-      }
-#endif
+		int64_t start = Hitch::Now();
 
 		spritesheet[sheetno] = new NXSurface;
 		spritesheet[sheetno]->LoadImage(pbm_name, true);
@@ -90,7 +99,33 @@ static void Sprites::LoadSheetIfNeeded(int sheetno)
 			if (sheetno == 3)	// Caret.pbm
 				spritesheet[sheetno]->FillRect(40, 58, 41, 58, 0, 0, 0);
 		}
+		
+		Hitch::Event(HE_SHEET_LOAD, start, pbm_name);
+		sheet_noted[sheetno] = bundle_recording();
 	}
+	else if (sheet_noted[sheetno] != bundle_recording())
+	{
+		// it was loaded on an earlier stage, but this stage uses it too
+		char pbm_name[1024];
+		get_sheet_path(sheetno, pbm_name, sizeof(pbm_name));
+		bundle_note(pbm_name);
+		
+		sheet_noted[sheetno] = bundle_recording();
+	}
+}
+
+// gives the full path of the given sheet's pbm
+static void get_sheet_path(int sheetno, char *buffer, int bufsize)
+{
+	retro_create_subpath_string(buffer, bufsize, g_dir, data_dir, sheetfiles.StringAt(sheetno));
+
+#ifdef _WIN32
+      for (int i = 0; buffer[i]; i++)
+      {
+         if (buffer[i] == '/')
+            buffer[i] = '\\';
+      }
+#endif
 }
 
 
@@ -258,6 +293,7 @@ int sheetdatalength, spritesdatalength;
 	
 	create_slope_boxes();
 	offset_by_draw_points();
+	sprites_geom_changed();
 
    // for sprites which only have 1 dir (no separate frames for left & right),
    // create a 2nd identical dir as the rest of the engine doesn't bother
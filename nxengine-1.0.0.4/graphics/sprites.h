@@ -8,12 +8,19 @@
 #include "../siflib/sif.h"
 extern SIFSprite sprites[MAX_SPRITES];
 
+// objects keep their own copies of their sprite's bbox, solidbox and draw points.
+// anything which changes those in the middle of the game must call this afterwards,
+// so that they know to take them again.
+extern uint32_t sprites_geom_gen;
+static inline void sprites_geom_changed(void) { sprites_geom_gen++; }
+
 
 namespace Sprites
 {
 	bool Init();
 	void Close();
 	void FlushSheets();
+	int CountLoadedSheets();
 	
 	static void LoadSheetIfNeeded(int spr);
 	
@@ -34,25 +34,24 @@ void c------------------------------() {}
 bool Tileset::Load(int new_tileset)
 {
 char fname[MAXPATHLEN];
+char fname_tmp[1024];
+
+#ifdef _WIN32
+      char slash = '\\';
+#else
+      char slash = '/';
+#endif
+	snprintf(fname, sizeof(fname), "%s%cPrt%s.pbm", stage_dir, slash, tileset_names[new_tileset]);
+	retro_create_path_string(fname_tmp, sizeof(fname_tmp), g_dir, fname);
 
 	if (new_tileset != current_tileset)
 	{
-                char fname_tmp[1024];
 		if (tileset)
 		{
 			delete tileset;
 			current_tileset = -1;
 		}
 		
-#ifdef _WIN32
-      char slash = '\\';
-#else
-      char slash = '/';
-#endif
-		snprintf(fname, sizeof(fname), "%s%cPrt%s.pbm", stage_dir, slash, tileset_names[new_tileset]);
-
-		retro_create_path_string(fname_tmp, sizeof(fname_tmp), g_dir, fname);
-
 		NX_LOG("Tileset::Load: %s\n", fname_tmp);
 		
 		// always use SDL_DisplayFormat on tilesets; they need to come out of 8-bit
@@ -63,6 +62,11 @@ char fname[MAXPATHLEN];
 		
 		current_tileset = new_tileset;
 	}
+	else
+	{
+		// it's still loaded from the last stage, but it's part of this one too
+		bundle_note(fname_tmp);
+	}
 	
 	return 0;
 }
@@ -0,0 +1,238 @@
+
+// the hitch recorder; see hitch.h.
+
+#include "nx.h"
+#include "libretro/libretro_shared.h"
+#include "hitch.fdh"
+
+static const char *zone_names[] = { "tick", "video", "audio", "physics", "map", "mix" };
+
+static const char *event_names[] =
+{
+	"stage load", "sheet load", "music start", "music gen",
+	"profile save", "settings save", "replay flush"
+};
+
+struct HitchFrame
+{
+	int frameno;
+	int usec;
+	int zone_usec[HZ_NUM_ZONES];
+	
+	int nobjects;
+	int map, mode;
+};
+
+struct HitchEvent
+{
+	int frameno;
+	int offset;				// usec into the frame it began, or -1 if between frames
+	int usec;
+	int type;
+	char what[24];
+};
+
+static struct
+{
+	HitchFrame frames[HITCH_RING_FRAMES];
+	HitchEvent events[HITCH_RING_EVENTS];
+	int nframes;			// total recorded; the newest is at (nframes - 1) % HITCH_RING_FRAMES
+	int nevents;
+	
+	HitchFrame cur;
+	bool in_frame;
+	int64_t frame_start;
+	int64_t zone_start[HZ_NUM_ZONES];
+	
+	int pending;			// frames to go before the dump is written, 0 if none
+	int hitch_frame;
+	int hitch_usec;
+	int last_hitch;
+	int ndumps;
+} hitch;
+
+
+void Hitch::BeginFrame(void)
+{
+	memset(&hitch.cur, 0, sizeof(hitch.cur));
+	hitch.cur.frameno = hitch.nframes;
+	
+	hitch.frame_start = retro_get_usec();
+	hitch.in_frame = true;
+}
+
+void Hitch::EndFrame(void)
+{
+HitchFrame *f = &hitch.cur;
+Object *o;
+
+	f->usec = (int)(retro_get_usec() - hitch.frame_start);
+	f->map = game.curmap;
+	f->mode = game.mode;
+	FOREACH_OBJECT(o) f->nobjects++;
+	
+	hitch.frames[hitch.nframes % HITCH_RING_FRAMES] = *f;
+	hitch.nframes++;
+	hitch.in_frame = false;
+	
+	if (perf_enabled)
+		PerfCount::EndFrame();
+	
+	// the dump waits a little after the hitch, so it shows what came after too
+	if (hitch.pending && --hitch.pending == 0)
+	{
+		char reason[80];
+		snprintf(reason, sizeof(reason), "frame %d took %d usec, over the %d usec budget", \
+				hitch.hitch_frame, hitch.hitch_usec, Budget());
+		
+		Dump(reason);
+	}
+	
+	int budget = Budget();
+	if (budget && f->usec > budget && !hitch.pending)
+	{
+		// writing the dump is a hitch in itself, so don't let a run of slow
+		// frames fill the disk with them.
+		if (hitch.ndumps == 0 || f->frameno - hitch.last_hitch >= HITCH_COOLDOWN)
+		{
+			hitch.pending = HITCH_POST_FRAMES;
+			hitch.hitch_frame = f->frameno;
+			hitch.hitch_usec = f->usec;
+			hitch.last_hitch = f->frameno;
+		}
+	}
+}
+
+/*
+void c------------------------------() {}
+*/
+
+void Hitch::BeginZone(int zone)
+{
+	hitch.zone_start[zone] = retro_get_usec();
+	
+	if (perf_enabled)
+		PerfCount::BeginZone(zone);
+}
+
+void Hitch::EndZone(int zone)
+{
+	if (perf_enabled)
+		PerfCount::EndZone(zone);
+	
+	hitch.cur.zone_usec[zone] += (int)(retro_get_usec() - hitch.zone_start[zone]);
+}
+
+const char *Hitch::ZoneName(int zone)
+{
+	return zone_names[zone];
+}
+
+int64_t Hitch::Now(void)
+{
+	return retro_get_usec();
+}
+
+// records that an event of the given type ran from "start" (from Now()) until now.
+// "what" is an optional filename or the like; only the last part of a path is kept.
+void Hitch::Event(int type, int64_t start, const char *what)
+{
+	int64_t now = retro_get_usec();
+	HitchEvent *ev = &hitch.events[hitch.nevents % HITCH_RING_EVENTS];
+	hitch.nevents++;
+	
+	ev->frameno = hitch.nframes;
+	ev->offset = hitch.in_frame ? (int)(start - hitch.frame_start) : -1;
+	ev->usec = (int)(now - start);
+	ev->type = type;
+	ev->what[0] = 0;
+	
+	if (what)
+	{
+		const char *slash = strrchr(what, '/');
+		const char *bslash = strrchr(what, '\\');
+		
+		if (bslash > slash) slash = bslash;
+		if (slash) what = slash + 1;
+		
+		maxcpy(ev->what, what, sizeof(ev->what));
+	}
+}
+
+/*
+void c------------------------------() {}
+*/
+
+// returns the current frame budget in usec, or 0 if the recorder isn't to dump.
+int Hitch::Budget(void)
+{
+	if (settings->hitch_budget == 0)
+		return HITCH_DEFAULT_BUDGET;
+	
+	return (settings->hitch_budget > 0) ? settings->hitch_budget : 0;
+}
+
+// writes everything in the rings out to the next hitchN.txt.
+bool Hitch::Dump(const char *reason)
+{
+char fname[16];
+char path[MAXPATHLEN];
+int i;
+
+	snprintf(fname, sizeof(fname), "hitch%d.txt", hitch.ndumps % HITCH_MAX_DUMPS);
+	retro_create_path_string(path, sizeof(path), g_dir, fname);
+	
+	FILE *fp = fopen(path, "wb");
+	if (!fp)
+	{
+		NX_ERR("Hitch::Dump: couldn't open '%s'\n", path);
+		return 1;
+	}
+	
+	hitch.ndumps++;
+	NX_LOG("Hitch: %s; see '%s'\n", reason, path);
+	
+	int first = hitch.nframes - HITCH_RING_FRAMES;
+	if (first < 0) first = 0;
+	
+	fprintf(fp, "%s\n\n", reason);
+	fprintf(fp, "   frame    usec");
+	for(i=0;i<HZ_NUM_ZONES;i++)
+		fprintf(fp, " %7s", zone_names[i]);
+	fprintf(fp, " objects  map mode\n");
+	
+	for(int n=first;n<hitch.nframes;n++)
+	{
+		HitchFrame *f = &hitch.frames[n % HITCH_RING_FRAMES];
+		
+		fprintf(fp, "%c%7d %7d", (n == hitch.hitch_frame) ? '>' : ' ', f->frameno, f->usec);
+		for(i=0;i<HZ_NUM_ZONES;i++)
+			fprintf(fp, " %7d", f->zone_usec[i]);
+		fprintf(fp, " %7d %4d %4d\n", f->nobjects, f->map, f->mode);
+	}
+	
+	fprintf(fp, "\n   frame  offset    usec  event\n");
+	
+	i = hitch.nevents - HITCH_RING_EVENTS;
+	if (i < 0) i = 0;
+	
+	for(;i<hitch.nevents;i++)
+	{
+		HitchEvent *ev = &hitch.events[i % HITCH_RING_EVENTS];
+		if (ev->frameno < first)
+			continue;
+		
+		if (ev->offset >= 0)
+			fprintf(fp, " %7d %7d %7d  ", ev->frameno, ev->offset, ev->usec);
+		else
+			fprintf(fp, " %7d       - %7d  ", ev->frameno, ev->usec);
+		
+		if (ev->what[0])
+			fprintf(fp, "%s %s\n", event_names[ev->type], ev->what);
+		else
+			fprintf(fp, "%s\n", event_names[ev->type]);
+	}
+	
+	fclose(fp);
+	return 0;
+}
@@ -0,0 +1,65 @@
+
+#ifndef _HITCH_H
+#define _HITCH_H
+
+// the hitch recorder is a flight recorder for long frames. it's always running,
+// keeping a ring of the last couple of seconds of frame timings, along with
+// events such as sprite sheets being loaded on first draw, music being generated
+// and files being saved. when a frame goes over the budget, the frames around it
+// are written out to a hitchN.txt in the data dir, so that a stall seen once in
+// the wild can be put down to something without having to catch it in a profiler.
+
+#define HITCH_RING_FRAMES		128			// frames of history kept
+#define HITCH_RING_EVENTS		256
+#define HITCH_POST_FRAMES		30			// frames after the hitch included in the dump
+
+#define HITCH_DEFAULT_BUDGET	50000		// usec; three frames at 60fps
+#define HITCH_COOLDOWN			600			// min frames between two dumps
+#define HITCH_MAX_DUMPS			8			// hitch0.txt - hitch7.txt, reused in turn
+
+// the parts of a frame that are timed every frame
+enum HitchZones
+{
+	HZ_TICK,			// running the game
+	HZ_VIDEO,			// handing the frame to the frontend
+	HZ_AUDIO,			// mixing and handing over the audio
+	
+	// parts of those, for seeing where the time in them goes
+	HZ_PHYSICS,			// Objects::PhysicsSim
+	HZ_MAP_DRAW,		// drawing the map tiles and backdrop
+	HZ_MIX,				// mixaudio
+	
+	HZ_NUM_ZONES
+};
+
+// things which are timed whenever they happen
+enum HitchEvents
+{
+	HE_STAGE_LOAD,
+	HE_SHEET_LOAD,
+	HE_MUSIC_START,
+	HE_MUSIC_GEN,
+	HE_PROFILE_SAVE,
+	HE_SETTINGS_SAVE,
+	HE_REPLAY_FLUSH,
+	
+	HE_NUM_EVENTS
+};
+
+namespace Hitch
+{
+	void BeginFrame(void);
+	void EndFrame(void);
+	
+	void BeginZone(int zone);
+	void EndZone(int zone);
+	const char *ZoneName(int zone);
+	
+	int64_t Now(void);
+	void Event(int type, int64_t start, const char *what=NULL);
+	
+	int Budget(void);
+	bool Dump(const char *reason);
+};
+
+#endif
@@ -23,6 +23,10 @@ bool inventory_init(int param)
 {
 	memset(&inv, 0, sizeof(inv));
 	
+	// the scene is the same one as under the Map System if we've come back from it
+	if (param != 1)
+		ThawScene();
+	
 	inv.curselector = &inv.armssel;
 	inv.armssel.cursel = RefreshInventoryScreen();
 	inv.curselector->lastsel = -9999;		// run the script first time
@@ -55,7 +59,7 @@ void inventory_tick(void)
 	RunSelector(inv.curselector);
 	
 	// draw
-	DrawScene();
+	DrawFrozenScene();
 	DrawInventory();
 	textbox.Draw();
 }
@@ -92,9 +92,15 @@ void retro_get_system_av_info(struct retro_system_av_info *info)
    info->timing.sample_rate = 22050.0;
 }
 
+void nx_log_set_frontend(retro_log_printf_t log);
+
 void retro_init(void)
 {
    enum retro_pixel_format rgb565;
+   struct retro_log_callback logging;
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_LOG_INTERFACE, &logging))
+      nx_log_set_frontend(logging.log);
 
 #ifdef FRONTEND_SUPPORTS_RGB565
    rgb565 = RETRO_PIXEL_FORMAT_RGB565;
@@ -145,34 +151,83 @@ void retro_reset(void)
 
 void mixaudio(int16_t *stream, size_t len_samples);
 
-#if 0
+#if defined(_XBOX)
+#include <xtl.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#else
 #include <time.h>
-static int64_t get_usec(void)
+#include <sys/time.h>
+#endif
+
+// a free-running microsecond clock, for measuring how long things take.
+// only differences between two readings are meaningful.
+int64_t retro_get_usec(void)
 {
-   struct timespec tv;
-   clock_gettime(CLOCK_MONOTONIC, &tv);
-   return (int64_t)tv.tv_sec * 1000000 + (int64_t)tv.tv_nsec / 1000;
-}
+#ifdef _WIN32
+   static LARGE_INTEGER freq;
+   LARGE_INTEGER count;
+
+   if (!freq.QuadPart)
+      QueryPerformanceFrequency(&freq);
+
+   QueryPerformanceCounter(&count);
+   return (int64_t)(count.QuadPart * 1000000 / freq.QuadPart);
+#elif defined(CLOCK_MONOTONIC)
+   // not the time of day, which can jump when the system clock is set
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (int64_t)ts.tv_sec * 1000000 + (ts.tv_nsec / 1000);
+#else
+   struct timeval tv;
+   gettimeofday(&tv, NULL);
+   return (int64_t)tv.tv_sec * 1000000 + (int64_t)tv.tv_usec;
 #endif
+}
+
+// which of the two audio frame lengths comes next; see retro_run.
+static unsigned audio_phase = 0;
+
+// restarts the alternation of audio frame lengths, so that a sequence of
+// frames (e.g. a replay) mixes the same way no matter when it begins.
+void retro_sync_audio_phase(void)
+{
+   audio_phase = 0;
+}
+
+// the number of audio frames to hand over with the next video frame
+static unsigned next_audio_frames(void)
+{
+   // Average audio frames / video frame: 367.5.
+   audio_phase++;
+   return (22050 + (audio_phase & 1 ? 30 : -30)) / 60;
+}
 
 void retro_run(void)
 {
    poll_cb();
    static unsigned frame_cnt = 0;
 
+   nx_log_begin_frame();
+   Hitch::BeginFrame();
+
    //fprintf(stderr, "[NX]: Start frame.\n");
-   //int64_t start_time = get_usec();
+   //int64_t start_time = retro_get_usec();
 
    if (retro_60hz)
    {
-      //int64_t start_time_frame = get_usec();
+      //int64_t start_time_frame = retro_get_usec();
+      Hitch::BeginZone(HZ_TICK);
       while (!run_main());
-      //int64_t total_time_frame = get_usec() - start_time_frame;
+      Hitch::EndZone(HZ_TICK);
+      //int64_t total_time_frame = retro_get_usec() - start_time_frame;
       //fprintf(stderr, "[NX]: total_time_frame took %lld usec.\n", (long long)total_time_frame);
 
-      //int64_t start_time_frame_cb = get_usec();
+      //int64_t start_time_frame_cb = retro_get_usec();
+      Hitch::BeginZone(HZ_VIDEO);
       video_cb(retro_frame_buffer, retro_frame_buffer_width, retro_frame_buffer_height, retro_frame_buffer_pitch);
-      //int64_t total_time_frame_cb = get_usec() - start_time_frame_cb;
+      Hitch::EndZone(HZ_VIDEO);
+      //int64_t total_time_frame_cb = retro_get_usec() - start_time_frame_cb;
       //fprintf(stderr, "[NX]: total_time_frame_cb took %lld usec.\n", (long long)total_time_frame_cb);
 
       frame_cnt++;
@@ -181,8 +236,13 @@ void retro_run(void)
    {
       if (frame_cnt % 6)
       {
+         Hitch::BeginZone(HZ_TICK);
          while (!run_main());
+         Hitch::EndZone(HZ_TICK);
+
+         Hitch::BeginZone(HZ_VIDEO);
          video_cb(retro_frame_buffer, retro_frame_buffer_width, retro_frame_buffer_height, retro_frame_buffer_pitch);
+         Hitch::EndZone(HZ_VIDEO);
       }
       else
          video_cb(NULL, SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_WIDTH * sizeof(uint16_t)); // Dupe every 6th frame.
@@ -191,19 +251,46 @@ void retro_run(void)
    }
 
    int16_t samples[(2 * 22050) / 60 + 1] = {0};
+   unsigned frames = next_audio_frames();
 
-   // Average audio frames / video frame: 367.5.
-   unsigned frames = (22050 + (frame_cnt & 1 ? 30 : -30)) / 60;
-
+   Hitch::BeginZone(HZ_AUDIO);
+   Hitch::BeginZone(HZ_MIX);
    mixaudio(samples, frames * 2);
+   Hitch::EndZone(HZ_MIX);
    audio_batch_cb(samples, frames);
+   Hitch::EndZone(HZ_AUDIO);
 
    g_frame_cnt++;
+   Hitch::EndFrame();
+   nx_log_end_frame();
 
-   //int64_t total_time = get_usec() - start_time;
+   //int64_t total_time = retro_get_usec() - start_time;
    //fprintf(stderr, "[NX]: Frame took %lld usec.\n", (long long)total_time);
 }
 
+// runs one frame the same way retro_run does (at 60hz), for the environments in
+// nx_env.cpp. nothing is handed to the frontend, and the audio is only advanced,
+// not mixed; the game can't tell the difference.
+void retro_run_headless(void)
+{
+   nx_log_begin_frame();
+   Hitch::BeginFrame();
+
+   Hitch::BeginZone(HZ_TICK);
+   while (!run_main());
+   Hitch::EndZone(HZ_TICK);
+
+   unsigned frames = next_audio_frames();
+
+   Hitch::BeginZone(HZ_MIX);
+   mixaudio(NULL, frames * 2);
+   Hitch::EndZone(HZ_MIX);
+
+   g_frame_cnt++;
+   Hitch::EndFrame();
+   nx_log_end_frame();
+}
+
 void retro_unload_cartridge(void) {}
 
 size_t retro_serialize_size(void)
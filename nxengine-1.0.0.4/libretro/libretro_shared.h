@@ -1,6 +1,8 @@
 #ifndef _LIBRETRO_SHARED_H
 #define _LIBRETRO_SHARED_H
 
+#include <stdint.h>
+
 #ifdef _WIN32
 #define snprintf _snprintf
 #endif
@@ -8,6 +10,10 @@
 void retro_create_subpath_string(char *fname, size_t fname_size, const char * dir, const char * subdir, const char * filename);
 void retro_create_path_string(char *fname, size_t fname_size, const char * dir, const char * filename);
 
+int64_t retro_get_usec(void);
+void retro_sync_audio_phase(void);
+void retro_run_headless(void);
+
 extern char g_dir[1024];
 
 #endif
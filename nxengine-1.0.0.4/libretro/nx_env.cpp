@@ -0,0 +1,644 @@
+
+// running the game as a set of environments; see nx_env.h.
+
+#include "libretro.h"
+#include "../nx.h"
+#include "libretro_shared.h"
+#include "nx_env.h"
+#include "../observe.h"
+#include "../graphics/lowres.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/socket.h>
+	#include <sys/wait.h>
+	#define NX_ENV_FORK
+	
+	#ifndef MAP_ANONYMOUS
+		#define MAP_ANONYMOUS	MAP_ANON
+	#endif
+	#ifndef MSG_NOSIGNAL		// see start_workers
+		#define MSG_NOSIGNAL	0
+	#endif
+#endif
+
+// commands sent to the workers, one byte each
+#define ENV_CMD_RESET		'r'
+#define ENV_CMD_STEP		's'
+#define ENV_CMD_QUIT		'q'
+
+// one for each environment. when there are workers, these are in memory
+// shared with them, so only the commands themselves go through the sockets.
+struct EnvSlot
+{
+	uint32_t input;
+	uint32_t seed;
+	nx_env_state state;
+	
+	int obs_size;			// of the observation, or 0 if there isn't one yet
+	nx_obs obs;
+};
+
+struct EnvWorker
+{
+	int pid;
+	int fd;					// our end of the socket the commands go through
+};
+
+struct nx_env
+{
+	int count;
+	EnvSlot *slots;
+	
+	uint8_t *pixels;		// the low-res frames, one after the other, or NULL if not drawn
+	int pixels_size;		// of each one
+	EnvWorker *workers;		// NULL if the environment is run in this process
+};
+
+#include "nx_env.fdh"
+
+static bool env_loaded = false;		// the game is loaded once per process, then reused
+static char env_exe_path[MAXPATHLEN];	// what it was loaded from
+static bool env_exists = false;
+static uint32_t env_buttons = 0;	// what's held down in the environment this process runs
+static bool env_observe = false;	// if set, observations are written after each frame
+static uint8_t *env_pixels = NULL;	// the low-res frame of the environment this process runs
+static int env_pixel_shift = 0;
+static char env_error[256];			// why the last nx_env_create failed
+
+/*
+void c------------------------------() {}
+*/
+
+// we're the frontend, so there's nothing to tell the core
+static bool env_environment(unsigned cmd, void *data)
+{
+	return false;
+}
+
+// the input callback for the game, which reads the buttons from the current mask
+static int16_t env_input_state(unsigned port, unsigned device, unsigned index, unsigned id)
+{
+	if (port != 0 || device != RETRO_DEVICE_JOYPAD || id >= 32)
+		return 0;
+	
+	return (env_buttons >> id) & 1;
+}
+
+// records why nx_env_create failed, for nx_env_error
+static void set_error(const char *fmt, ...)
+{
+va_list ar;
+
+	va_start(ar, fmt);
+	vsnprintf(env_error, sizeof(env_error), fmt, ar);
+	va_end(ar);
+	
+	NX_ERR("nx_env: %s\n", env_error);
+}
+
+/*
+void c------------------------------() {}
+*/
+
+// loads the game into this process, leaving it ready to have a new game started.
+// returns 1 on failure.
+static bool load_game(const char *exe_path)
+{
+struct retro_game_info info;
+
+	// retro_init and retro_load_game can't be run twice, so after the first
+	// time, the game that's already loaded is reused. the workers only ever
+	// changed their own copies of it, and resets start it over anyway.
+	if (env_loaded)
+	{
+		if (strcmp(exe_path, env_exe_path))
+		{
+			set_error("the game was already loaded from '%s'; it can't be loaded from another file in the same process", env_exe_path);
+			return 1;
+		}
+		
+		if (!game.running)
+		{
+			set_error("the game loaded from '%s' has stopped and can't be loaded again", env_exe_path);
+			return 1;
+		}
+		
+		return 0;
+	}
+	
+	// pre_main doesn't check that it's there before reading from it
+	FILE *fp = fopen(exe_path, "rb");
+	if (!fp)
+	{
+		set_error("couldn't open '%s'", exe_path);
+		return 1;
+	}
+	
+	fclose(fp);
+	
+	env_loaded = true;
+	maxcpy(env_exe_path, exe_path, sizeof(env_exe_path));
+	
+	retro_set_environment(env_environment);
+	retro_set_input_state(env_input_state);
+	retro_init();
+	
+	memset(&info, 0, sizeof(info));
+	info.path = exe_path;
+	
+	// pre_main only sets game.running once everything's up
+	retro_load_game(&info);
+	if (!game.running)
+	{
+		set_error("failed to load the game from '%s'", exe_path);
+		return 1;
+	}
+	
+	// no-one is going to see or hear it. the sound effects are still
+	// played, as some of the AI checks whether they're playing, and the
+	// frames are still drawn, as things like which objects are onscreen are
+	// worked out there; only the pixels and samples themselves are skipped.
+	Graphics::SetDrawing(false);
+	settings->music_enabled = 0;
+	return 0;
+}
+
+/*
+void c------------------------------() {}
+*/
+
+// starts a new game in the environment this process runs
+static void env_reset(EnvSlot *slot)
+{
+	memset(inputs, 0, sizeof(inputs));
+	memset(lastinputs, 0, sizeof(lastinputs));
+	env_buttons = 0;
+	
+	StopLoopSounds();
+	StopScripts();
+	
+	game.pause(false);
+	game.switchstage.mapno = NEW_GAME;
+	game.setmode(GM_NORMAL);
+	
+	seedrand(slot->seed);
+	retro_sync_audio_phase();
+	
+	memset(&slot->state, 0, sizeof(nx_env_state));
+	
+	if (env_pixels) LowRes::SetTarget(env_pixels, env_pixel_shift);
+	retro_run_headless();
+	
+	get_state(slot);
+}
+
+// runs the environment this process runs one frame, with the slot's input
+static void env_step(EnvSlot *slot)
+{
+	env_buttons = slot->input;
+	
+	if (env_pixels) LowRes::SetTarget(env_pixels, env_pixel_shift);
+	retro_run_headless();
+	
+	slot->state.frame++;
+	get_state(slot);
+}
+
+static void get_state(EnvSlot *slot)
+{
+nx_env_state *st = &slot->state;
+
+	st->map = game.curmap;
+	st->mode = game.mode;
+	st->nobjects = 0;
+	
+	Object *o;
+	FOREACH_OBJECT(o)
+		st->nobjects++;
+	
+	if (player)
+	{
+		Weapon *wpn = &player->weapons[player->curWeapon];
+		
+		st->inputs_locked = player->inputs_locked;
+		st->x = player->x;
+		st->y = player->y;
+		st->xinertia = player->xinertia;
+		st->yinertia = player->yinertia;
+		st->hp = player->hp;
+		st->max_hp = player->maxHealth;
+		
+		st->weapon = player->curWeapon;
+		st->weapon_level = wpn->level;
+		st->weapon_xp = wpn->xp;
+		st->ammo = wpn->maxammo ? wpn->ammo : 0;
+	}
+	
+	// once done, an environment stays done until it's reset, even if
+	// the game goes on to something else, e.g. the title screen
+	if (st->done == NX_ENV_RUNNING)
+	{
+		if (player && (player->dead || player->hp <= 0))
+		{
+			st->done = NX_ENV_DIED;
+		}
+		else if (!game.running || game.mode == GM_CREDITS || \
+				game.mode == GM_TITLE || game.mode == GM_INTRO)
+		{
+			st->done = NX_ENV_ENDED;
+		}
+	}
+	
+	if (env_observe)
+		slot->obs_size = Observe::Write(&slot->obs, sizeof(slot->obs));
+}
+
+/*
+void c------------------------------() {}
+*/
+
+nx_env *nx_env_create(const char *exe_path, int count, unsigned flags)
+{
+	if (env_exists)
+	{
+		set_error("there's already a set of environments");
+		return NULL;
+	}
+	
+	if (count < 1)
+	{
+		set_error("can't create %d environments", count);
+		return NULL;
+	}
+	
+	bool use_workers = (count > 1 || (flags & NX_ENV_WORKERS));
+	int pixel_shift = ((flags >> 4) & 7) - 1;
+	
+	if (pixel_shift > LOWRES_MAX_SHIFT)
+	{
+		set_error("can't draw frames shifted down by %d", pixel_shift);
+		return NULL;
+	}
+	
+	#ifndef NX_ENV_FORK
+		if (use_workers)
+		{
+			set_error("can't run more than one environment on this system");
+			return NULL;
+		}
+	#endif
+	
+	if (load_game(exe_path))
+		return NULL;
+	
+	// before the workers are started, so that they have it too
+	env_observe = (flags & NX_ENV_OBSERVE) ? true : false;
+	
+	env_pixel_shift = MAX(pixel_shift, 0);
+	
+	env_error[0] = 0;
+	
+	nx_env *env = (nx_env *)calloc(1, sizeof(nx_env));
+	env->count = count;
+	
+	if (pixel_shift >= 0)
+		env->pixels_size = LOWRES_WIDTH(pixel_shift) * LOWRES_HEIGHT(pixel_shift);
+	
+	if (use_workers)
+	{
+		if (start_workers(env))
+		{
+			free(env);
+			return NULL;
+		}
+	}
+	else
+	{
+		env->slots = (EnvSlot *)calloc(1, sizeof(EnvSlot));
+		
+		if (env->pixels_size)
+		{
+			env->pixels = (uint8_t *)calloc(1, env->pixels_size);
+			env_pixels = env->pixels;
+		}
+	}
+	
+	env_exists = true;
+	return env;
+}
+
+void nx_env_destroy(nx_env *env)
+{
+	if (!env)
+		return;
+	
+	if (env->workers)
+	{
+		stop_workers(env);
+	}
+	else
+	{
+		free(env->slots);
+		free(env->pixels);
+	}
+	
+	LowRes::SetTarget(NULL, 0);
+	env_pixels = NULL;
+	
+	free(env);
+	env_exists = false;
+}
+
+int nx_env_observation(nx_env *env, int index, void *buffer, int size)
+{
+	if (!env_observe || index < 0 || index >= env->count)
+		return -1;
+	
+	EnvSlot *slot = &env->slots[index];
+	if (slot->obs_size <= 0 || size < slot->obs_size)
+		return -1;
+	
+	memcpy(buffer, &slot->obs, slot->obs_size);
+	return slot->obs_size;
+}
+
+int nx_env_pixels(nx_env *env, int index, uint8_t *buffer, int size)
+{
+	if (!env->pixels || index < 0 || index >= env->count || size < env->pixels_size)
+		return -1;
+	
+	memcpy(buffer, &env->pixels[index * env->pixels_size], env->pixels_size);
+	return env->pixels_size;
+}
+
+const char *nx_env_error(void)
+{
+	return env_error;
+}
+
+int nx_env_count(nx_env *env)
+{
+	return env->count;
+}
+
+int nx_env_reset(nx_env *env, int index, uint32_t seed, nx_env_state *states)
+{
+	int first = (index < 0) ? 0 : index;
+	int last = (index < 0) ? (env->count - 1) : index;
+	bool lost = false;
+	
+	if (first >= env->count || last >= env->count)
+		return 1;
+	
+	for(int i=first;i<=last;i++)
+		env->slots[i].seed = seed;
+	
+	if (env->workers)
+	{
+		lost = run_workers(env, first, last, ENV_CMD_RESET);
+	}
+	else
+	{
+		env_reset(&env->slots[0]);
+	}
+	
+	if (states)
+	{
+		for(int i=0;i<env->count;i++)
+			states[i] = env->slots[i].state;
+	}
+	
+	return lost;
+}
+
+int nx_env_step(nx_env *env, const uint32_t *inputs, nx_env_state *states)
+{
+	bool lost = false;
+	
+	for(int i=0;i<env->count;i++)
+		env->slots[i].input = inputs[i];
+	
+	if (env->workers)
+	{
+		lost = run_workers(env, 0, env->count - 1, ENV_CMD_STEP);
+	}
+	else
+	{
+		env_step(&env->slots[0]);
+	}
+	
+	if (states)
+	{
+		for(int i=0;i<env->count;i++)
+			states[i] = env->slots[i].state;
+	}
+	
+	return lost;
+}
+
+/*
+void c------------------------------() {}
+*/
+
+#ifdef NX_ENV_FORK
+
+// forks off a worker process for each environment. they're forked after the game
+// has been loaded, so they start out with it already loaded, and share the memory
+// it's in until they write to it. returns 1 on failure.
+static bool start_workers(nx_env *env)
+{
+	int count = env->count;
+	
+	env->slots = (EnvSlot *)mmap(NULL, count * sizeof(EnvSlot), \
+					PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (env->slots == MAP_FAILED)
+	{
+		set_error("couldn't map the shared slots");
+		env->slots = NULL;
+		return 1;
+	}
+	
+	memset(env->slots, 0, count * sizeof(EnvSlot));
+	
+	// the workers draw their frames straight into here
+	if (env->pixels_size)
+	{
+		env->pixels = (uint8_t *)mmap(NULL, count * env->pixels_size, \
+						PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+		if (env->pixels == MAP_FAILED)
+		{
+			set_error("couldn't map the shared frames");
+			munmap(env->slots, count * sizeof(EnvSlot));
+			env->slots = NULL;
+			env->pixels = NULL;
+			return 1;
+		}
+	}
+	
+	env->workers = (EnvWorker *)calloc(count, sizeof(EnvWorker));
+	
+	// anything buffered would otherwise be written out by every worker too
+	fflush(NULL);
+	
+	for(int i=0;i<count;i++)
+	{
+		int fds[2];
+		
+		// sockets rather than pipes, so that writing to a worker which has
+		// died doesn't raise SIGPIPE in whatever program we're a part of.
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds))
+		{
+			set_error("couldn't create a socket for worker %d", i);
+			stop_workers(env);
+			return 1;
+		}
+		
+		#ifdef SO_NOSIGPIPE
+			int one = 1;
+			setsockopt(fds[0], SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+			setsockopt(fds[1], SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+		#endif
+		
+		int pid = fork();
+		if (pid < 0)
+		{
+			set_error("couldn't fork worker %d", i);
+			close(fds[0]);
+			close(fds[1]);
+			stop_workers(env);
+			return 1;
+		}
+		
+		if (pid == 0)
+		{
+			// the worker doesn't need the sockets of the workers before it
+			for(int j=0;j<i;j++)
+				close(env->workers[j].fd);
+			
+			close(fds[0]);
+			
+			if (env->pixels)
+				env_pixels = &env->pixels[i * env->pixels_size];
+			
+			run_worker(&env->slots[i], fds[1]);
+			_exit(0);
+		}
+		
+		close(fds[1]);
+		env->workers[i].pid = pid;
+		env->workers[i].fd = fds[0];
+	}
+	
+	NX_LOG("start_workers: started %d workers\n", count);
+	return 0;
+}
+
+// tells every worker to quit, and waits for them to do it
+static void stop_workers(nx_env *env)
+{
+	char cmd = ENV_CMD_QUIT;
+	int i;
+	
+	for(i=0;i<env->count;i++)
+	{
+		EnvWorker *w = &env->workers[i];
+		
+		if (w->pid > 0 && send(w->fd, &cmd, 1, MSG_NOSIGNAL) != 1)
+		{
+			NX_LOG("stop_workers: worker %d has already gone\n", i);
+		}
+	}
+	
+	for(i=0;i<env->count;i++)
+	{
+		EnvWorker *w = &env->workers[i];
+		if (w->pid <= 0)
+			continue;
+		
+		close(w->fd);
+		waitpid(w->pid, NULL, 0);
+	}
+	
+	munmap(env->slots, env->count * sizeof(EnvSlot));
+	if (env->pixels)
+		munmap(env->pixels, env->count * env->pixels_size);
+	
+	free(env->workers);
+	env->slots = NULL;
+	env->pixels = NULL;
+	env->workers = NULL;
+}
+
+// sends a command to workers first through last, then waits until they've all
+// done it, so that they all run at once. a worker which can't be reached has
+// its environment marked as lost; returns 1 if any are.
+static bool run_workers(nx_env *env, int first, int last, char cmd)
+{
+	bool lost = false;
+	char reply;
+	int i;
+	
+	for(i=first;i<=last;i++)
+	{
+		EnvWorker *w = &env->workers[i];
+		
+		if (w->pid > 0 && send(w->fd, &cmd, 1, MSG_NOSIGNAL) != 1)
+			lose_worker(env, i);
+	}
+	
+	for(i=first;i<=last;i++)
+	{
+		EnvWorker *w = &env->workers[i];
+		
+		if (w->pid > 0 && recv(w->fd, &reply, 1, 0) != 1)
+			lose_worker(env, i);
+		
+		if (w->pid <= 0)
+		{
+			env->slots[i].state.done = NX_ENV_LOST;
+			lost = true;
+		}
+	}
+	
+	return lost;
+}
+
+static void lose_worker(nx_env *env, int index)
+{
+	EnvWorker *w = &env->workers[index];
+	
+	NX_ERR("run_workers: lost worker %d\n", index);
+	
+	close(w->fd);
+	waitpid(w->pid, NULL, 0);
+	w->pid = 0;
+}
+
+// the main loop of a worker process: runs commands until told to quit
+static void run_worker(EnvSlot *slot, int fd)
+{
+	char cmd;
+	
+	while(recv(fd, &cmd, 1, 0) == 1)
+	{
+		switch(cmd)
+		{
+			case ENV_CMD_RESET: env_reset(slot); break;
+			case ENV_CMD_STEP: env_step(slot); break;
+			case ENV_CMD_QUIT: return;
+		}
+		
+		if (send(fd, &cmd, 1, MSG_NOSIGNAL) != 1)
+			return;
+	}
+}
+
+#else
+
+static bool start_workers(nx_env *env) { return 1; }
+static void stop_workers(nx_env *env) { }
+static bool run_workers(nx_env *env, int first, int last, char cmd) { return 1; }
+
+#endif
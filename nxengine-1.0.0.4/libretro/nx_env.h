@@ -0,0 +1,125 @@
+
+#ifndef _NX_ENV_H
+#define _NX_ENV_H
+
+// a C API for running the game as a set of environments, e.g. for training
+// agents or for bots, without a libretro frontend around it. a set of N
+// environments is created, and each call to nx_env_step runs all of them one
+// frame further, each with its own buttons, and returns what state each one
+// is in. the frames are run headless: nothing is drawn to the screen and no
+// audio is mixed, though the game runs exactly as it would otherwise.
+//
+// the engine keeps all of its state in globals, so there can only be one game
+// per process. when there's more than one environment (or NX_ENV_WORKERS is
+// given), each one is run in a worker process forked off once the game data
+// has been loaded, so they all step at the same time on as many cores as
+// there are. the workers' states come back through shared memory, so a step
+// costs no more than a byte written and read per worker on top of the frame
+// itself. forking needs a unix system; elsewhere only one environment can be
+// created. only one set of environments can exist at a time, but once one has
+// been destroyed, another can be created: the game is only loaded by the first
+// nx_env_create in a process, and later ones reuse it, so they must all be
+// given the same exe_path.
+//
+// this is meant to be used by a program which loads the core itself; it
+// isn't possible to use it from inside a frontend which is running the core.
+//
+// with NX_ENV_OBSERVE, each environment also writes a full observation of the
+// game (see nx_obs.h) after every reset and step, which nx_env_observation
+// copies out. and with NX_ENV_PIXELS(shift), each one is drawn, not to the screen,
+// but to a low-resolution grayscale picture of it, a byte per pixel, which is
+// the screen's size shifted down by shift (0-3); so NX_ENV_PIXELS(2) gives
+// 80x60. nx_env_pixels copies it out.
+
+#include <stdint.h>
+#include "nx_obs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// the inputs for each environment are a mask of the joypad buttons to hold
+// down: bit n is RETRO_DEVICE_ID_JOYPAD_* n, e.g. (1 << RETRO_DEVICE_ID_JOYPAD_LEFT).
+#define NX_ENV_BUTTON(id)		(1u << (id))
+
+// flags for nx_env_create
+#define NX_ENV_WORKERS			0x01		// use a worker process even for a single environment
+#define NX_ENV_OBSERVE			0x02		// write an observation after each reset and step
+#define NX_ENV_PIXELS(shift)	(((shift) + 1) << 4)	// draw a low-res picture of each frame
+
+#define NX_ENV_PIXELS_W(shift)	(320 >> (shift))
+#define NX_ENV_PIXELS_H(shift)	(240 >> (shift))
+
+// why an environment is done, in nx_env_state.done
+enum
+{
+	NX_ENV_RUNNING,			// not done
+	NX_ENV_DIED,			// the player died
+	NX_ENV_ENDED,			// the game ended, or went back to the title screen
+	NX_ENV_LOST				// the worker process running it has gone away
+};
+
+typedef struct nx_env nx_env;
+
+// what's returned about each environment after a reset or step. positions and
+// speeds are in the engine's fixed-point units, where 512 is one pixel.
+typedef struct nx_env_state
+{
+	uint32_t frame;			// frames stepped since the last reset
+	int32_t done;			// NX_ENV_*; stays set until the environment is reset
+	
+	int32_t map;			// stage number
+	int32_t mode;			// the game's mode (GM_NORMAL, GM_INVENTORY etc)
+	int32_t inputs_locked;	// 1 if a script has control of the player
+	
+	int32_t x, y;
+	int32_t xinertia, yinertia;
+	int32_t hp, max_hp;
+	
+	int32_t weapon;			// WPN_*, or 0 if none
+	int32_t weapon_level;	// 0-2
+	int32_t weapon_xp;
+	int32_t ammo;			// 0 for weapons which don't use it
+	
+	int32_t nobjects;		// objects in the stage, including the player
+} nx_env_state;
+
+// loads the game from the given data file (Doukutsu.exe) and creates count
+// environments. returns NULL if the game couldn't be loaded or the workers
+// couldn't be started, in which case nx_env_error says why.
+nx_env *nx_env_create(const char *exe_path, int count, unsigned flags);
+
+// returns why the last nx_env_create failed, or "" if it didn't
+const char *nx_env_error(void);
+
+// starts a new game in one environment, or in all of them if index is -1. seed
+// is the random seed to start with; the same seed and the same inputs give
+// the same run. the states after the first frame of the new game are written
+// to states[], which has room for every environment, if it isn't NULL.
+// returns nonzero if any of the environments have been lost.
+int nx_env_reset(nx_env *env, int index, uint32_t seed, nx_env_state *states);
+
+// runs every environment one frame, with inputs[i] held down in environment i,
+// and writes where each one is now to states[i]. environments which are done
+// are still stepped, so it's up to the caller to reset them. returns nonzero
+// if any of the environments have been lost.
+int nx_env_step(nx_env *env, const uint32_t *inputs, nx_env_state *states);
+
+// copies the observation of environment index after the last reset or step to
+// buffer, which should have room for NX_OBS_MAX_SIZE bytes. returns its size,
+// or -1 if there isn't one or it doesn't fit. needs NX_ENV_OBSERVE.
+int nx_env_observation(nx_env *env, int index, void *buffer, int size);
+
+// copies the picture of environment index's last frame to buffer, a row at a
+// time with no padding. returns its size, or -1 if it doesn't fit. needs
+// NX_ENV_PIXELS.
+int nx_env_pixels(nx_env *env, int index, uint8_t *buffer, int size);
+
+int nx_env_count(nx_env *env);
+void nx_env_destroy(nx_env *env);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,133 @@
+
+#ifndef _NX_OBS_H
+#define _NX_OBS_H
+
+// the layout of the observations written by Observe::Write (observe.cpp) and
+// returned by nx_env_observation: everything an agent or test oracle would
+// otherwise have to get by scraping the screen or reading the engine's globals,
+// in one flat block which can be read by casting it to an nx_obs.
+//
+// an observation is an nx_obs, cut off after hdr.nobjects objects; hdr.size is
+// how many bytes of it there are. everything is in the byte order of the system
+// which wrote it. positions, speeds and boxes are in the engine's fixed-point
+// units, where 512 is one pixel and 8192 is one tile.
+//
+// the version goes up whenever the layout changes, so a reader should check
+// it before going any further.
+
+#include <stdint.h>
+
+#define NX_OBS_MAGIC			0x424f584e		// "NXOB"
+#define NX_OBS_VERSION			1
+
+// the window of tiles around the player, which is a little bigger than the screen
+#define NX_OBS_TILES_W			25
+#define NX_OBS_TILES_H			19
+#define NX_OBS_TILES			(NX_OBS_TILES_W * NX_OBS_TILES_H)
+
+// at most this many objects are included, nearest the player first
+#define NX_OBS_MAX_OBJECTS		64
+
+// nx_obs_player.flags
+#define NX_OBS_BLOCKED_LEFT		0x0001
+#define NX_OBS_BLOCKED_RIGHT	0x0002
+#define NX_OBS_BLOCKED_UP		0x0004
+#define NX_OBS_BLOCKED_DOWN		0x0008		// standing on something
+#define NX_OBS_INPUTS_LOCKED	0x0010		// a script has control of the player
+#define NX_OBS_HIDDEN			0x0020
+#define NX_OBS_DEAD				0x0040
+#define NX_OBS_HURT				0x0080		// blinking after being hit; can't be hurt again
+#define NX_OBS_UNDERWATER		0x0100
+#define NX_OBS_RIDING			0x0200		// standing on a moving object
+#define NX_OBS_BOOSTING			0x0400
+
+// nx_obs_script.flags
+#define NX_OBS_SCRIPT_RUNNING	0x0001
+#define NX_OBS_SCRIPT_WAITKEY	0x0002		// waiting for a key to be pressed (<NOD)
+#define NX_OBS_TEXTBOX			0x0004		// a textbox is up
+#define NX_OBS_TEXTBOX_BUSY		0x0008		// and is still typing out its text
+#define NX_OBS_YESNO			0x0010		// a yes/no prompt is up
+#define NX_OBS_STAGESELECT		0x0020		// the teleporter menu is up
+#define NX_OBS_SAVESELECT		0x0040		// the save slot menu is up
+#define NX_OBS_PAUSED			0x0080		// the pause menu or options are up
+#define NX_OBS_FROZEN			0x0100		// the game is frozen by a script (<FRE/<PRI)
+
+// a tile's attributes are the TA_* bits from map.h; tiles outside the map
+// have this set, as well as being solid.
+#define NX_OBS_TILE_OUTSIDE		0x8000
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct nx_obs_header
+{
+	uint32_t magic;				// NX_OBS_MAGIC
+	uint16_t version;			// NX_OBS_VERSION
+	uint16_t size;				// bytes in this observation, including the header
+	uint32_t tick;				// frames run since the core was loaded
+	int16_t map;				// stage number
+	int16_t mode;				// the game's mode (GM_NORMAL, GM_INVENTORY etc)
+	int16_t nobjects;			// how many entries of objects[] follow
+	int16_t reserved;
+	int32_t tile_x, tile_y;		// map coordinates of the top-left tile of the window
+} nx_obs_header;
+
+typedef struct nx_obs_player
+{
+	int32_t x, y;				// position of the top-left of his sprite
+	int32_t xinertia, yinertia;
+	uint32_t flags;				// NX_OBS_BLOCKED_LEFT etc
+	int16_t hp, max_hp;
+	int16_t weapon;				// WPN_*, or 0 if none
+	int16_t weapon_level;		// 0-2
+	int16_t weapon_xp;
+	int16_t weapon_max_xp;		// xp needed for the next level
+	int16_t ammo, max_ammo;		// max_ammo is 0 for weapons which don't use it
+	int16_t air;				// air left, 0-1000
+	int16_t booster_fuel;
+	uint16_t equipmask;			// EQUIP_*
+	uint8_t dir;				// RIGHT or LEFT
+	uint8_t reserved[3];
+} nx_obs_player;
+
+typedef struct nx_obs_script
+{
+	int16_t scriptno;			// the running script, or -1 if none
+	int16_t pageno;				// which page it's from (SP_HEAD, SP_MAP etc)
+	uint16_t flags;				// NX_OBS_SCRIPT_RUNNING etc
+	uint16_t reserved;
+} nx_obs_script;
+
+typedef struct nx_obs_object
+{
+	uint16_t type;				// OBJ_*
+	int16_t hp;
+	int32_t left, top, right, bottom;	// hit box
+	int32_t xinertia, yinertia;
+	uint16_t flags;				// FLAG_* from game.h, e.g. FLAG_SHOOTABLE
+	uint8_t dir;
+	uint8_t reserved;
+} nx_obs_object;
+
+typedef struct nx_obs
+{
+	nx_obs_header hdr;
+	nx_obs_player player;
+	nx_obs_script script;
+	
+	// the window of tiles, a row at a time. the arrays are
+	// padded out so that the objects are aligned.
+	uint16_t tile_attr[(NX_OBS_TILES + 1) & ~1];
+	uint8_t tile[(NX_OBS_TILES + 3) & ~3];
+	
+	nx_obs_object objects[NX_OBS_MAX_OBJECTS];
+} nx_obs;
+
+#define NX_OBS_MAX_SIZE			sizeof(nx_obs)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
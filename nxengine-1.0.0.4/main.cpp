@@ -2,6 +2,7 @@
 #include "../nx.h"
 #include "../main.fdh"
 #include "libretro_shared.h";
+#include "bootcache.h"
 
 #ifdef _WIN32
 #include "msvc_compat.h"
@@ -45,6 +46,10 @@ SetLogFilename(debug_fname);
 	// load settings, or at least get the defaults,
 	// so we know the initial screen resolution.
 	settings_load();
+	
+	// now, so that the crcs taken while extracting are checked too
+	Shadow::Init();
+	PerfCount::Init();
 
    char filename[1024];
 	FILE *fp;
@@ -54,6 +59,9 @@ SetLogFilename(debug_fname);
 	retro_create_path_string(filename, sizeof(filename), g_dir, "Doukutsu.exe");
 	fp = fopen(filename, "rb");
 
+	// see if we can skip some of the work below by reusing what the last boot made
+	bootcache_open(fp);
+
    extract_files(fp);
 
 	if (sound_init()) { fatal("Failed to initialize sound."); error = 1; return; }
@@ -88,6 +96,9 @@ SetLogFilename(debug_fname);
 		error = 1;
 		return;
 	}
+	
+	// everything's up, so save anything that had to be regenerated for next time
+	bootcache_commit();
 	game.setmode(GM_NORMAL);
 	// set null stage just to have something to do while we go to intro
 	game.switchstage.mapno = 0;
@@ -122,7 +133,9 @@ SetLogFilename(debug_fname);
 
 void post_main(void)
 {
+	Soak::Stop();
 	Replay::close();
+	bundle_close();
 	game.close();
 	Carets::close();
 	
@@ -132,6 +145,9 @@ void post_main(void)
 	sound_close();
 	tsc_close();
 	textbox.Deinit();
+	
+	// last, as the sound effects may have been pointing into it
+	bootcache_close();
 }
 
 static bool gameloop(void)
@@ -244,7 +260,9 @@ loop:
 	in_gameloop = false;
 
 	game.stageboss.OnMapExit();
+	Replay::OnStageExit();
 	freshstart = false;
+	return false;
 }
 
 static inline void run_tick()
@@ -269,7 +287,11 @@ static inline void run_tick()
 	}
 	
 	// freeze frame
+	Soak::BeginFrame();
+	Governor::BeginFrame();
 	game.tick();
+	Governor::EndFrame();
+	Soak::EndFrame();
 
 	Replay::DrawStatus();
 
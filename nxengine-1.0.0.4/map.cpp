@@ -24,43 +24,58 @@ unsigned int tilekey[MAX_TILES];			// mapping from tile codes -> tile attributes
 // tile attributes (pxa), and script (tsc).
 bool load_stage(int stage_no)
 {
-char stage[MAXPATHLEN];
 char fname[MAXPATHLEN];
 
-char slash;
-#ifdef _WIN32
-slash = '\\';
-#else
-slash = '/';
-#endif
-
 	NX_LOG(" >> Entering stage %d: '%s'.\n", stage_no, stages[stage_no].stagename);
+	int64_t start = Hitch::Now();
 	game.curmap = stage_no;		// do it now so onspawn events will have it
 	
+	bundle_enter_stage(stage_no);
+	
 	if (Tileset::Load(stages[stage_no].tileset))
 		return 1;
 	
 	// get the base name of the stage without extension
 	const char *mapname = stages[stage_no].filename;
 	if (!strcmp(mapname, "lounge")) mapname = "Lounge";
-	snprintf(stage, sizeof(stage), "%s%c%s", stage_dir, slash, mapname);
 	
-	snprintf(fname, sizeof(fname), "%s%c%s.pxm", g_dir, slash, stage);
+	if (get_data_name(fname, stage_dir, mapname, "pxm")) return 1;
 	if (load_map(fname)) return 1;
 	
-	snprintf(fname, sizeof(fname), "%s%c%s%c%s.pxa", g_dir, slash, stage_dir, slash, tileset_names[stages[stage_no].tileset]);
+	if (get_data_name(fname, stage_dir, tileset_names[stages[stage_no].tileset], "pxa")) return 1;
 	if (load_tileattr(fname)) return 1;
 	
-	snprintf(fname, sizeof(fname), "%s%c%s.pxe", g_dir, slash, stage);
+	if (get_data_name(fname, stage_dir, mapname, "pxe")) return 1;
 	if (load_entities(fname)) return 1;
 	
-	snprintf(fname, sizeof(fname), "%s%c%s.tsc", g_dir, slash, stage);
+	if (get_data_name(fname, stage_dir, mapname, "tsc")) return 1;
 	if (tsc_load(fname, SP_MAP) == -1) return 1;
 	
 	map_set_backdrop(stages[stage_no].bg_no);
 	map.scrolltype = stages[stage_no].scroll_type;
 	map.motionpos = 0;
 	
+	Hitch::Event(HE_STAGE_LOAD, start, stages[stage_no].filename);
+	return 0;
+}
+
+// gives the full path of the file "name.ext" in the given dir under the data dir.
+// returns 1 if it's too long.
+static bool get_data_name(char *fname, const char *dir, const char *name, const char *ext)
+{
+char slash;
+#ifdef _WIN32
+slash = '\\';
+#else
+slash = '/';
+#endif
+
+	if (snprintf(fname, MAXPATHLEN, "%s%c%s%c%s.%s", g_dir, slash, dir, slash, name, ext) >= MAXPATHLEN)
+	{
+		NX_ERR("get_data_name: the path to '%s.%s' is too long\n", name, ext);
+		return 1;
+	}
+	
 	return 0;
 }
 
@@ -71,19 +86,21 @@ void c------------------------------() {}
 // load a PXM map
 bool load_map(const char *fname)
 {
-	FILE *fp;
+	DBuffer file;
 	int x, y;
 
    NX_LOG("load_map: %s\n", fname);
 
-	fp = fopen(fname, "rb");
-	if (!fp)
+	if (bundle_read_file(fname, &file))
 	{
 		NX_ERR("load_map: no such file: '%s'\n", fname);
 		return 1;
 	}
 	
-	if (!fverifystring(fp, "PXM"))
+	const uint8_t *ptr = file.Data();
+	const uint8_t *end = ptr + file.Length();
+	
+	if (file.Length() < 8 || memcmp(ptr, "PXM", 3))
 	{
 		NX_ERR("load_map: invalid map format: '%s'\n", fname);
 		return 1;
@@ -91,14 +108,13 @@ bool load_map(const char *fname)
 	
 	memset(&map, 0, sizeof(map));
 	
-	fgetc(fp);
-	map.xsize = fgeti(fp);
-	map.ysize = fgeti(fp);
+	ptr += 4;
+	map.xsize = read_U16(&ptr, end);
+	map.ysize = read_U16(&ptr, end);
 	
 	if (map.xsize > MAP_MAXSIZEX || map.ysize > MAP_MAXSIZEY)
 	{
 		NX_ERR("load_map: map is too large -- size %dx%d but max is %dx%d\n", map.xsize, map.ysize, MAP_MAXSIZEX, MAP_MAXSIZEY);
-		fclose(fp);
 		return 1;
 	}
 	else
@@ -109,11 +125,9 @@ bool load_map(const char *fname)
 	for(y=0;y<map.ysize;y++)
 	for(x=0;x<map.xsize;x++)
 	{
-		map.tiles[x][y] = fgetc(fp);
+		map.tiles[x][y] = (ptr < end) ? *ptr++ : 0xff;
 	}
 	
-	fclose(fp);
-	
 	map.maxxscroll = (((map.xsize * TILE_W) - SCREEN_WIDTH) - 8) << CSF;
 	map.maxyscroll = (((map.ysize * TILE_H) - SCREEN_HEIGHT) - 8) << CSF;
 	
@@ -125,7 +139,7 @@ bool load_map(const char *fname)
 // load a PXE (entity list for a map)
 bool load_entities(const char *fname)
 {
-FILE *fp;
+DBuffer file;
 int i;
 int nEntities;
 
@@ -135,30 +149,39 @@ int nEntities;
 
 	NX_LOG("load_entities: reading in %s\n", fname);
 	// now we can load in the new objects
-	fp = fopen(fname, "rb");
-	if (!fp)
+	if (bundle_read_file(fname, &file))
 	{
 		NX_ERR("load_entities: no such file: '%s'\n", fname);
 		return 1;
 	}
 	
-	if (!fverifystring(fp, "PXE"))
+	const uint8_t *ptr = file.Data();
+	const uint8_t *end = ptr + file.Length();
+	
+	if (file.Length() < 8 || memcmp(ptr, "PXE", 3))
 	{
 		NX_ERR("load_entities: not a PXE: '%s'\n", fname);
 		return 1;
 	}
 	
-	fgetc(fp);
-	nEntities = fgetl(fp);
+	ptr += 4;
+	nEntities = read_U32(&ptr, end);
+	
+	// each one is 6 words
+	if (nEntities < 0 || nEntities > (end - ptr) / 12)
+	{
+		NX_ERR("load_entities: '%s' is truncated\n", fname);
+		return 1;
+	}
 	
 	for(i=0;i<nEntities;i++)
 	{
-		int x = fgeti(fp);
-		int y = fgeti(fp);
-		int id1 = fgeti(fp);
-		int id2 = fgeti(fp);
-		int type = fgeti(fp);
-		int flags = fgeti(fp);
+		int x = read_U16(&ptr, end);
+		int y = read_U16(&ptr, end);
+		int id1 = read_U16(&ptr, end);
+		int id2 = read_U16(&ptr, end);
+		int type = read_U16(&ptr, end);
+		int flags = read_U16(&ptr, end);
 		
 		int dir = (flags & FLAG_FACES_RIGHT) ? RIGHT : LEFT;
 		
@@ -218,22 +241,20 @@ int nEntities;
 	}
 	
 	//NX_LOG("load_entities: loaded %d objects\n", nEntities);
-	fclose(fp);
 	return 0;
 }
 
 // loads a pxa (tileattr) file
 bool load_tileattr(const char *fname)
 {
-FILE *fp;
+DBuffer file;
 int i;
 unsigned char tc;
 
 	map.nmotiontiles = 0;
 
 	NX_LOG("load_pxa: reading in %s\n", fname);
-	fp = fopen(fname, "rb");
-	if (!fp)
+	if (bundle_read_file(fname, &file))
 	{
 		NX_ERR("load_pxa: no such file: '%s'\n", fname);
 		return 1;
@@ -241,7 +262,7 @@ unsigned char tc;
 	
 	for(i=0;i<256;i++)
 	{
-		tc = fgetc(fp);
+		tc = (i < file.Length()) ? file.Data()[i] : 0xff;
 		tilecode[i] = tc;
 		tileattr[i] = tilekey[tc];
 		//NX_LOG("Tile %02x   TC %02x    Attr %08x   tilekey[%02x] = %08x\n", i, tc, tileattr[i], tc, tilekey[tc]);
@@ -264,7 +285,6 @@ unsigned char tc;
 		}
 	}
 	
-	fclose(fp);
 	return 0;
 }
 
@@ -421,20 +441,16 @@ int i, x;
 static bool LoadBackdropIfNeeded(int backdrop_no)
 {
 char fname[MAXPATHLEN];
-char slash;
-#ifdef _WIN32
-slash = '\\';
-#else
-slash = '/';
-#endif
+
+	if (get_data_name(fname, data_dir, backdrop_names[backdrop_no], "pbm"))
+		return 1;
+	
 	// load backdrop now if it hasn't already been loaded
 	if (!backdrop[backdrop_no])
 	{
 		// use chromakey (transparency) on bkwater, all others don't
 		bool use_chromakey = (backdrop_no == 8);
 		
-		snprintf(fname, sizeof(fname), "%s%c%s%c%s.pbm", g_dir, slash, data_dir, slash, backdrop_names[backdrop_no]);
-		
 		backdrop[backdrop_no] = NXSurface::FromFile(fname, use_chromakey);
 		if (!backdrop[backdrop_no])
 		{
@@ -442,6 +458,10 @@ slash = '/';
 			return 1;
 		}
 	}
+	else
+	{
+		bundle_note(fname);
+	}
 	
 	return 0;
 }
@@ -466,6 +486,20 @@ int i;
 	}
 }
 
+// returns how many backdrops are currently loaded
+int map_count_backdrops(void)
+{
+int i, count = 0;
+
+	for(i=0;i<MAX_BACKDROPS;i++)
+	{
+		if (backdrop[i])
+			count++;
+	}
+	
+	return count;
+}
+
 
 /*
 void c------------------------------() {}
@@ -42,6 +42,10 @@ bool ms_init(int return_to_mode)
 	memset(&ms, 0, sizeof(ms));
 	ms.return_gm = return_to_mode;
 	ms.lastbuttondown = true;
+	
+	if (return_to_mode != GM_INVENTORY)
+		ThawScene();
+	
 	ms.w = map.xsize;
 	ms.h = map.ysize;
 	
@@ -76,7 +80,7 @@ void c------------------------------() {}
 
 void ms_tick(void)
 {
-	DrawScene();
+	DrawFrozenScene();
 	draw_banner();
 	
 	if (ms.state == MS_EXPANDING)
@@ -54,8 +54,15 @@ class Object;
 #include "console.h"
 #include "debug.h"
 #include "game.h"
+#include "triggers.h"
 #include "caret.h"
 #include "screeneffect.h"
+#include "governor.h"
+#include "soak.h"
+#include "hitch.h"
+#include "perfcount.h"
+#include "shadow.h"
+#include "bundle.h"
 #include "settings.h"
 #include "slope.h"
 #include "player.h"
@@ -0,0 +1,182 @@
+
+// the backend behind NX_LOG, NX_WARN and NX_ERR.
+//
+// writing each message to stderr as it happens can stall the frame when stderr is
+// slow or piped somewhere, and a few of them fire every tick. so while a frame is
+// running, messages are only formatted into a queue, which is handed over to the
+// frontend's log interface once the frame is done. without one, they go to stderr,
+// but only a few lines at the end of each frame, so that a burst of them is spread
+// out over the next few frames rather than stalling one; if they keep coming faster
+// than that, the queue fills up and the extra ones are dropped and counted. outside
+// of a frame, such as while starting up, everything goes straight through.
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "nx_logger.h"
+#include "libretro/libretro.h"
+#include "libretro/libretro_shared.h"
+#include "nx_logger.fdh"
+
+#define NXL_QUEUE_SIZE		128			// messages that can be held back
+#define NXL_DRAIN_PER_FRAME	4			// of them written to stderr after each frame
+#define NXL_LINE_LEN		256
+
+#define NXL_SITE_BURST		8			// a call site may log this many messages...
+#define NXL_SITE_WINDOW		60			// ...every this many frames
+
+static const char *level_prefix[] = { "NX: ", "NX [WARN] :: ", "NX [ERROR] :: " };
+static const enum retro_log_level retro_level[] = { RETRO_LOG_INFO, RETRO_LOG_WARN, RETRO_LOG_ERROR };
+
+struct NXLogLine
+{
+	int level;
+	char text[NXL_LINE_LEN];
+};
+
+static struct
+{
+	// a ring, of nqueued lines starting at head
+	NXLogLine queue[NXL_QUEUE_SIZE];
+	int head;
+	int nqueued;
+	int dropped;			// didn't fit in the queue since it was last emptied
+	
+	bool in_frame;
+	int frame;				// frames so far, for the rate limiting
+	int level;				// messages below this level are ignored
+	
+	retro_log_printf_t frontend;
+} nxl;
+
+
+void nx_log(NXLogSite *site, int level, const char *fmt, ...)
+{
+va_list ar;
+char buffer[NXL_LINE_LEN];
+
+	if (level < nxl.level)
+		return;
+	
+	// once a site has used up it's burst, it's quiet until the window ends,
+	// and the first message after that says how many were missed.
+	if (nxl.frame - site->window >= NXL_SITE_WINDOW || nxl.frame < site->window)
+	{
+		site->window = nxl.frame;
+		site->count = 0;
+	}
+	
+	if (++site->count > NXL_SITE_BURST)
+	{
+		site->suppressed++;
+		return;
+	}
+	
+	if (site->suppressed)
+	{
+		snprintf(buffer, sizeof(buffer), "(%d more like the following were suppressed)\n", site->suppressed);
+		site->suppressed = 0;
+		emit(level, buffer);
+	}
+	
+	va_start(ar, fmt);
+	vsnprintf(buffer, sizeof(buffer), fmt, ar);
+	va_end(ar);
+	
+	emit(level, buffer);
+}
+
+static void emit(int level, const char *text)
+{
+	if (!nxl.in_frame)
+	{
+		// anything still held back from the last frame comes first
+		drain(NXL_QUEUE_SIZE);
+		
+		write_line(level, text);
+		if (!nxl.frontend) fflush(stderr);
+		return;
+	}
+	
+	if (nxl.nqueued >= NXL_QUEUE_SIZE)
+	{
+		nxl.dropped++;
+		return;
+	}
+	
+	NXLogLine *line = &nxl.queue[(nxl.head + nxl.nqueued) % NXL_QUEUE_SIZE];
+	line->level = level;
+	strcpy(line->text, text);
+	nxl.nqueued++;
+}
+
+static void write_line(int level, const char *text)
+{
+	if (nxl.frontend)
+		nxl.frontend(retro_level[level], "%s%s", level_prefix[level], text);
+	else
+		fprintf(stderr, "%s%s", level_prefix[level], text);
+}
+
+/*
+void c------------------------------() {}
+*/
+
+void nx_log_begin_frame(void)
+{
+	nxl.in_frame = true;
+}
+
+// writes out what was logged during the frame: all of it if it's going to the
+// frontend, or just the first few lines of the queue if it's going to stderr.
+void nx_log_end_frame(void)
+{
+	nxl.in_frame = false;
+	nxl.frame++;
+	
+	drain(nxl.frontend ? NXL_QUEUE_SIZE : NXL_DRAIN_PER_FRAME);
+}
+
+// writes out up to max lines from the front of the queue. once it's empty,
+// says how many didn't fit in it.
+static void drain(int max)
+{
+	if (!nxl.nqueued && !nxl.dropped)
+		return;
+	
+	while(nxl.nqueued && max > 0)
+	{
+		NXLogLine *line = &nxl.queue[nxl.head];
+		write_line(line->level, line->text);
+		
+		nxl.head = (nxl.head + 1) % NXL_QUEUE_SIZE;
+		nxl.nqueued--;
+		max--;
+	}
+	
+	if (!nxl.nqueued && nxl.dropped)
+	{
+		char buffer[80];
+		snprintf(buffer, sizeof(buffer), "%d more log messages were dropped\n", nxl.dropped);
+		write_line(NXL_WARN, buffer);
+		nxl.dropped = 0;
+	}
+	
+	if (!nxl.frontend)
+		fflush(stderr);
+}
+
+void nx_log_set_frontend(retro_log_printf_t log)
+{
+	nxl.frontend = log;
+}
+
+void nx_log_set_level(int level)
+{
+	nxl.level = level;
+}
+
+int nx_log_get_level(void)
+{
+	return nxl.level;
+}
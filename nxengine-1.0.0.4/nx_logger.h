@@ -17,6 +17,34 @@
 #ifndef __NX_LOGGER_H
 #define __NX_LOGGER_H
 
+// the levels NX_LOG, NX_WARN and NX_ERR log at
+enum NXLogLevels
+{
+   NXL_INFO,
+   NXL_WARN,
+   NXL_ERR,
+   NXL_OFF
+};
+
+// every call site gets one of these, to limit how often it can be heard from
+struct NXLogSite
+{
+   int window;
+   int count;
+   int suppressed;
+};
+
+void nx_log(NXLogSite *site, int level, const char *fmt, ...);
+void nx_log_begin_frame(void);
+void nx_log_end_frame(void);
+void nx_log_set_level(int level);
+int nx_log_get_level(void);
+
+#define NX_LOG_SITE(LEVEL, ...) do { \
+      static NXLogSite nx_log_site; \
+      nx_log(&nx_log_site, LEVEL, __VA_ARGS__); \
+   } while (0)
+
 #ifdef RELEASE_BUILD
 #define NX_LOG(...)
 #define NX_ERR(...)
@@ -37,10 +65,7 @@
 #if defined(ANDROID) && defined(HAVE_LOGGER)
 #define  NX_LOG(...)  __android_log_print(ANDROID_LOG_INFO, "NX: ", __VA_ARGS__)
 #else
-#define NX_LOG(...) do { \
-   fprintf(LOG_FILE, "NX: " __VA_ARGS__); \
-   fflush(LOG_FILE); \
-   } while (0)
+#define NX_LOG(...) NX_LOG_SITE(NXL_INFO, __VA_ARGS__)
 #endif
 #endif
 
@@ -59,10 +84,7 @@
 #if defined(ANDROID) && defined(HAVE_LOGGER)
 #define  NX_ERR(...)  __android_log_print(ANDROID_LOG_INFO, "NX [ERROR] :: ", __VA_ARGS__)
 #else
-#define NX_ERR(...) do { \
-      fprintf(LOG_FILE, "NX [ERROR] :: " __VA_ARGS__); \
-      fflush(LOG_FILE); \
-   } while (0)
+#define NX_ERR(...) NX_LOG_SITE(NXL_ERR, __VA_ARGS__)
 #endif
 #endif
 
@@ -81,10 +103,7 @@
 #if defined(ANDROID) && defined(HAVE_LOGGER)
 #define  NX_WARN(...)  __android_log_print(ANDROID_LOG_INFO, "NX [WARN] :: ", __VA_ARGS__)
 #else
-#define NX_WARN(...) do { \
-      fprintf(LOG_FILE, "NX [WARN] :: " __VA_ARGS__); \
-      fflush(LOG_FILE); \
-   } while (0)
+#define NX_WARN(...) NX_LOG_SITE(NXL_WARN, __VA_ARGS__)
 #endif
 #endif
 
@@ -50,6 +50,8 @@ Object * const &o = this;
 	// remove from list and free
 	LL_REMOVE(o, prev, next, firstobject, lastobject);
 	LL_REMOVE(o, lower, higher, lowestobject, highestobject);
+	Objects::RemoveFromAftermoveList(o);
+	if (o->type == OBJ_HVTRIGGER) Triggers::Invalidate();
 	if (o == player) player = NULL;
 	
 	delete o;
@@ -81,6 +83,9 @@ void Object::SetType(int type)
 {
 Object * const &o = this;
 
+	if (type == OBJ_HVTRIGGER || o->type == OBJ_HVTRIGGER)
+		Triggers::Invalidate();
+	
 	o->type = type;
 	o->sprite = objprop[type].sprite;
 	o->hp = objprop[type].initial_hp;
@@ -91,6 +96,8 @@ Object * const &o = this;
 	// (did this so toroko would handle slopes properly in Gard cutscene)
 	o->nxflags = objprop[type].defaultnxflags;
 	
+	Objects::UpdateAftermoveList(o);
+	
 	// apply defaultflags to new object type, but NOT ALL defaultflags.
 	// otherwise <CNP's _WILL_ get messed up.
 	const static int flags_to_keep = \
@@ -255,6 +262,36 @@ int x, y, xoff, yoff;
 	return false;
 }
 
+// re-takes the bbox and solidbox from the sprite; see geom in object.h.
+void Object::RefreshBoxes()
+{
+	SIFSprite *spr = &sprites[this->sprite];
+	
+	geom.x1 = (spr->bbox.x1 << CSF);
+	geom.y1 = (spr->bbox.y1 << CSF);
+	geom.x2 = (spr->bbox.x2 << CSF);
+	geom.y2 = (spr->bbox.y2 << CSF);
+	
+	geom.solid_x1 = (spr->solidbox.x1 << CSF);
+	geom.solid_y1 = (spr->solidbox.y1 << CSF);
+	geom.solid_x2 = (spr->solidbox.x2 << CSF);
+	geom.solid_y2 = (spr->solidbox.y2 << CSF);
+	
+	geom.sprite = this->sprite;
+	geom.gen = sprites_geom_gen;
+}
+
+void Object::RefreshCenter()
+{
+	geom.center_x = (Width() / 2) - DrawPointX();
+	geom.center_y = (Height() / 2) - DrawPointY();
+	
+	geom.center_sprite = this->sprite;
+	geom.center_frame = this->frame;
+	geom.center_dir = this->dir;
+	geom.center_gen = sprites_geom_gen;
+}
+
 // treats each point in pointlist as an offset within the object, and returns
 // true if any of the points intersect with object o2's solidbox.
 bool Object::CheckSolidIntersect(Object *other, const Point *pointlist, int npoints)
@@ -7,6 +7,8 @@
 #define XP_MED_AMT				5
 #define XP_LARGE_AMT			20
 
+class IrregularBBox;
+
 class Object
 {
 public:
@@ -118,6 +120,11 @@ public:
 	
 	SIFSprite *Sprite();
 	
+	void UpdateBoxes();
+	void UpdateCenter();
+	void RefreshBoxes();
+	void RefreshCenter();
+	
 	// ---------------------------------------
 	
 	int type;								// object's type
@@ -187,14 +194,40 @@ public:
 	// if true, object has been deleted and should be freed before next tick
 	bool deleted;
 	
+	// the sprite's bbox, solidbox and center, relative to x,y and already shifted
+	// up by CSF, so that collision and AI code doesn't have to go through sprites[]
+	// (and for the center, the frame and dir tables) every time. they're refreshed
+	// only when the sprite, frame or dir they were taken from has changed.
+	struct
+	{
+		int sprite;							// -1 if they haven't been taken yet
+		uint32_t gen;						// sprites_geom_gen when they were taken
+		int x1, y1, x2, y2;
+		int solid_x1, solid_y1, solid_x2, solid_y2;
+		
+		int center_sprite, center_frame;
+		uint8_t center_dir;
+		uint32_t center_gen;
+		int center_x, center_y;
+	} geom;
+	
 	// the dual-layered linked-list. one list is order of creation is the
 	// order AI routines are run in, the other is the z-order and is the
 	// order the objects are drawn in.
 	Object *prev, *next;
 	Object *lower, *higher;
 	
+	// the subset of the creation-order list whose type has an aftermove routine,
+	// so the aftermove phase doesn't have to visit every object.
+	Object *prev_aftermove, *next_aftermove;
+	bool on_aftermove_list;
+	
 	Object *linkedobject;
 	
+	// if set, the object is hit by shots and touches the player through the
+	// rectangles of this compound bbox rather than through it's sprite's bbox.
+	IrregularBBox *ibbox;
+	
 	// AI variables used for specific AI functions
 	union
 	{
@@ -273,6 +306,9 @@ public:
 		{
 			bool is_horizontal;
 			int x1, y1, x2, y2;
+			
+			uint32_t index_gen;		// for the trigger index; see triggers.h
+			uint32_t hit_stamp;
 		} hvt;	// hvtrigger
 		
 		struct
@@ -289,18 +325,18 @@ inline int Object::Height()			{ return (sprites[this->sprite].h << CSF); }
 inline int Object::BBoxWidth()		{ return (((sprites[this->sprite].bbox.x2 - sprites[this->sprite].bbox.x1) + 1) << CSF); }
 inline int Object::BBoxHeight()		{ return (((sprites[this->sprite].bbox.y2 - sprites[this->sprite].bbox.y1) + 1) << CSF); }
 
-inline int Object::CenterX()		{ return (this->x + (Width() / 2)) - DrawPointX(); }
-inline int Object::CenterY()		{ return (this->y + (Height() / 2)) - DrawPointY(); }
+inline int Object::CenterX()		{ UpdateCenter(); return (this->x + geom.center_x); }
+inline int Object::CenterY()		{ UpdateCenter(); return (this->y + geom.center_y); }
 
-inline int Object::Left()			{ return (this->x + (sprites[this->sprite].bbox.x1 << CSF)); }
-inline int Object::Right()			{ return (this->x + (sprites[this->sprite].bbox.x2 << CSF)); }
-inline int Object::Top()			{ return (this->y + (sprites[this->sprite].bbox.y1 << CSF)); }
-inline int Object::Bottom()			{ return (this->y + (sprites[this->sprite].bbox.y2 << CSF)); }
+inline int Object::Left()			{ UpdateBoxes(); return (this->x + geom.x1); }
+inline int Object::Right()			{ UpdateBoxes(); return (this->x + geom.x2); }
+inline int Object::Top()			{ UpdateBoxes(); return (this->y + geom.y1); }
+inline int Object::Bottom()			{ UpdateBoxes(); return (this->y + geom.y2); }
 
-inline int Object::SolidLeft()		{ return (this->x + (sprites[this->sprite].solidbox.x1 << CSF)); }
-inline int Object::SolidRight()		{ return (this->x + (sprites[this->sprite].solidbox.x2 << CSF)); }
-inline int Object::SolidTop()		{ return (this->y + (sprites[this->sprite].solidbox.y1 << CSF)); }
-inline int Object::SolidBottom()	{ return (this->y + (sprites[this->sprite].solidbox.y2 << CSF)); }
+inline int Object::SolidLeft()		{ UpdateBoxes(); return (this->x + geom.solid_x1); }
+inline int Object::SolidRight()		{ UpdateBoxes(); return (this->x + geom.solid_x2); }
+inline int Object::SolidTop()		{ UpdateBoxes(); return (this->y + geom.solid_y1); }
+inline int Object::SolidBottom()	{ UpdateBoxes(); return (this->y + geom.solid_y2); }
 
 inline int Object::ActionPointX()	{ return (this->x + (sprites[this->sprite].frame[this->frame].dir[this->dir].actionpoint.x << CSF)); }
 inline int Object::ActionPointY()	{ return (this->y + (sprites[this->sprite].frame[this->frame].dir[this->dir].actionpoint.y << CSF)); }
@@ -312,6 +348,19 @@ inline int Object::DrawPointY()		{ return (sprites[this->sprite].frame[this->fra
 
 inline SIFSprite *Object::Sprite()	{ return &sprites[this->sprite]; }
 
+inline void Object::UpdateBoxes()
+{
+	if (geom.sprite != this->sprite || geom.gen != sprites_geom_gen)
+		RefreshBoxes();
+}
+
+inline void Object::UpdateCenter()
+{
+	if (geom.center_sprite != this->sprite || geom.center_frame != this->frame || \
+		geom.center_dir != this->dir || geom.center_gen != sprites_geom_gen)
+		RefreshCenter();
+}
+
 
 // game objects
 
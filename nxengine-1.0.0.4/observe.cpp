@@ -0,0 +1,232 @@
+
+// observations of the game state; see observe.h.
+
+#include "nx.h"
+#include "observe.h"
+#include "observe.fdh"
+
+// objects overlapping the window which are considered for the nearest NX_OBS_MAX_OBJECTS
+#define MAX_CANDIDATES		256
+
+struct Candidate
+{
+	Object *o;
+	int64_t dist;
+};
+
+
+// writes an observation of the current game state to buffer, which should be at
+// least NX_OBS_MAX_SIZE bytes; if it's smaller, fewer objects are included.
+// returns the size of the observation, or -1 if the buffer is too small for
+// even the part before the objects.
+int Observe::Write(void *buffer, int size)
+{
+nx_obs *obs = (nx_obs *)buffer;
+int fixed_size = offsetof(nx_obs, objects);
+
+	if (size < fixed_size)
+		return -1;
+	
+	memset(obs, 0, fixed_size);
+	
+	obs->hdr.magic = NX_OBS_MAGIC;
+	obs->hdr.version = NX_OBS_VERSION;
+	obs->hdr.tick = retro_get_tick();
+	obs->hdr.map = game.curmap;
+	obs->hdr.mode = game.mode;
+	
+	int max_objects = MIN((size - fixed_size) / (int)sizeof(nx_obs_object), NX_OBS_MAX_OBJECTS);
+	
+	observe_script(&obs->script);
+	
+	if (player)
+	{
+		observe_player(&obs->player);
+		observe_tiles(obs);
+		obs->hdr.nobjects = observe_objects(obs, max_objects);
+	}
+	
+	obs->hdr.size = fixed_size + (obs->hdr.nobjects * sizeof(nx_obs_object));
+	return obs->hdr.size;
+}
+
+/*
+void c------------------------------() {}
+*/
+
+static void observe_player(nx_obs_player *p)
+{
+Weapon *wpn = &player->weapons[player->curWeapon];
+
+	p->x = player->x;
+	p->y = player->y;
+	p->xinertia = player->xinertia;
+	p->yinertia = player->yinertia;
+	
+	p->hp = player->hp;
+	p->max_hp = player->maxHealth;
+	
+	p->weapon = player->curWeapon;
+	p->weapon_level = wpn->level;
+	p->weapon_xp = wpn->xp;
+	p->weapon_max_xp = wpn->max_xp[wpn->level];
+	p->max_ammo = wpn->maxammo;
+	p->ammo = wpn->maxammo ? wpn->ammo : 0;
+	
+	p->air = player->airleft;
+	p->booster_fuel = player->boosterfuel;
+	p->equipmask = player->equipmask;
+	p->dir = player->dir;
+	
+	uint32_t flags = 0;
+	if (player->blockl) flags |= NX_OBS_BLOCKED_LEFT;
+	if (player->blockr) flags |= NX_OBS_BLOCKED_RIGHT;
+	if (player->blocku) flags |= NX_OBS_BLOCKED_UP;
+	if (player->blockd) flags |= NX_OBS_BLOCKED_DOWN;
+	if (player->inputs_locked) flags |= NX_OBS_INPUTS_LOCKED;
+	if (player->hide) flags |= NX_OBS_HIDDEN;
+	if (player->dead) flags |= NX_OBS_DEAD;
+	if (player->hurt_time) flags |= NX_OBS_HURT;
+	if (player->touchattr & TA_WATER) flags |= NX_OBS_UNDERWATER;
+	if (player->riding) flags |= NX_OBS_RIDING;
+	if (player->booststate) flags |= NX_OBS_BOOSTING;
+	p->flags = flags;
+}
+
+static void observe_script(nx_obs_script *s)
+{
+ScriptInstance *script = GetCurrentScriptInstance();
+uint16_t flags = 0;
+
+	s->scriptno = -1;
+	s->pageno = -1;
+	
+	if (script)
+	{
+		s->scriptno = script->scriptno;
+		s->pageno = script->pageno;
+		
+		flags |= NX_OBS_SCRIPT_RUNNING;
+		if (script->waitforkey) flags |= NX_OBS_SCRIPT_WAITKEY;
+	}
+	
+	if (textbox.IsVisible()) flags |= NX_OBS_TEXTBOX;
+	if (textbox.IsBusy()) flags |= NX_OBS_TEXTBOX_BUSY;
+	if (textbox.YesNoPrompt.IsVisible()) flags |= NX_OBS_YESNO;
+	if (textbox.StageSelect.IsVisible()) flags |= NX_OBS_STAGESELECT;
+	if (textbox.SaveSelect.IsVisible()) flags |= NX_OBS_SAVESELECT;
+	if (game.paused) flags |= NX_OBS_PAUSED;
+	if (game.frozen) flags |= NX_OBS_FROZEN;
+	
+	s->flags = flags;
+}
+
+/*
+void c------------------------------() {}
+*/
+
+// the window is centered on the tile the middle of the player is in
+static void observe_tiles(nx_obs *obs)
+{
+	int cx = ((player->CenterX() >> CSF) / TILE_W);
+	int cy = ((player->CenterY() >> CSF) / TILE_H);
+	
+	obs->hdr.tile_x = cx - (NX_OBS_TILES_W / 2);
+	obs->hdr.tile_y = cy - (NX_OBS_TILES_H / 2);
+	
+	int i = 0;
+	for(int y=0;y<NX_OBS_TILES_H;y++)
+	{
+		int mapy = obs->hdr.tile_y + y;
+		
+		for(int x=0;x<NX_OBS_TILES_W;x++)
+		{
+			int mapx = obs->hdr.tile_x + x;
+			
+			if (mapx < 0 || mapy < 0 || mapx >= map.xsize || mapy >= map.ysize)
+			{
+				obs->tile[i] = 0;
+				obs->tile_attr[i] = (NX_OBS_TILE_OUTSIDE | TA_SOLID);
+			}
+			else
+			{
+				int t = map.tiles[mapx][mapy];
+				
+				obs->tile[i] = t;
+				obs->tile_attr[i] = (tileattr[t] & ~NX_OBS_TILE_OUTSIDE);
+			}
+			
+			i++;
+		}
+	}
+}
+
+// fills in the objects whose boxes overlap the window of tiles, nearest the
+// player first. returns how many there are.
+static int observe_objects(nx_obs *obs, int max_objects)
+{
+static Candidate candidates[MAX_CANDIDATES];
+int ncandidates = 0;
+Object *o;
+
+	int x1 = MAPX(obs->hdr.tile_x);
+	int y1 = MAPY(obs->hdr.tile_y);
+	int x2 = MAPX(obs->hdr.tile_x + NX_OBS_TILES_W);
+	int y2 = MAPY(obs->hdr.tile_y + NX_OBS_TILES_H);
+	
+	int px = player->CenterX();
+	int py = player->CenterY();
+	
+	FOREACH_OBJECT(o)
+	{
+		if (o == player || o->deleted)
+			continue;
+		
+		if (o->Right() < x1 || o->Left() >= x2 || \
+			o->Bottom() < y1 || o->Top() >= y2)
+			continue;
+		
+		int64_t dx = (o->CenterX() - px);
+		int64_t dy = (o->CenterY() - py);
+		
+		candidates[ncandidates].o = o;
+		candidates[ncandidates].dist = (dx * dx) + (dy * dy);
+		
+		if (++ncandidates >= MAX_CANDIDATES)
+			break;
+	}
+	
+	if (ncandidates > 1)
+		qsort(candidates, ncandidates, sizeof(Candidate), compare_candidates);
+	
+	int count = MIN(ncandidates, max_objects);
+	for(int i=0;i<count;i++)
+	{
+		nx_obs_object *ob = &obs->objects[i];
+		o = candidates[i].o;
+		
+		ob->type = o->type;
+		ob->hp = o->hp;
+		ob->left = o->Left();
+		ob->top = o->Top();
+		ob->right = o->Right();
+		ob->bottom = o->Bottom();
+		ob->xinertia = o->xinertia;
+		ob->yinertia = o->yinertia;
+		ob->flags = o->flags;
+		ob->dir = o->dir;
+		ob->reserved = 0;
+	}
+	
+	return count;
+}
+
+static int compare_candidates(const void *a, const void *b)
+{
+	int64_t da = ((const Candidate *)a)->dist;
+	int64_t db = ((const Candidate *)b)->dist;
+	
+	if (da < db) return -1;
+	if (da > db) return 1;
+	return 0;
+}
@@ -0,0 +1,18 @@
+
+#ifndef _OBSERVE_H
+#define _OBSERVE_H
+
+// observations of the game state, for agents and test oracles: where the player
+// is and how he's doing, the objects and tiles around him, and what the scripts
+// and textboxes are up to, written out in a flat binary block after a tick so
+// they don't need anything drawn to get at it. the layout is in libretro/nx_obs.h,
+// which is plain C so that it can be used by whatever's reading them.
+
+#include "libretro/nx_obs.h"
+
+namespace Observe
+{
+	int Write(void *buffer, int size);
+};
+
+#endif
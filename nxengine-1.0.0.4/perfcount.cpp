@@ -0,0 +1,365 @@
+
+// hardware performance counters; see perfcount.h.
+
+#include "nx.h"
+#include "libretro/libretro_shared.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#ifdef __NR_perf_event_open
+	#define PERFCOUNT_SUPPORTED
+#endif
+#endif
+
+#include "perfcount.fdh"
+
+bool perf_enabled = false;
+
+static const char *counter_names[] =
+{
+	"cycles", "instructions", "l1d misses", "llc misses", "branch misses"
+};
+
+static struct
+{
+	int fds[PC_NUM_COUNTERS];				// -1 for counters which couldn't be opened
+	int index[PC_NUM_COUNTERS];				// where each one is in a read of the group
+	int leader;								// fd of the group, or -1 if there isn't one
+	int ncounters;
+	
+	uint64_t start[HZ_NUM_ZONES][PC_NUM_COUNTERS];
+	int64_t start_usec[HZ_NUM_ZONES];
+	
+	uint64_t total[HZ_NUM_ZONES][PC_NUM_COUNTERS];
+	int64_t total_usec[HZ_NUM_ZONES];
+	int nframes;
+} pc;
+
+
+// turns the counters on at startup if the NX_PERF environment variable is set
+void PerfCount::Init(void)
+{
+	const char *env = getenv("NX_PERF");
+	
+	for(int i=0;i<PC_NUM_COUNTERS;i++)
+	{
+		pc.fds[i] = -1;
+		pc.index[i] = -1;
+	}
+	pc.leader = -1;
+	
+	if (env && atoi(env))
+		SetEnabled(true);
+}
+
+// returns 1 if the counters were to be turned on, but none of them are available.
+// the zones are still timed then, so that the dump at least shows where the time went.
+bool PerfCount::SetEnabled(bool enable)
+{
+	if (enable == perf_enabled)
+		return 0;
+	
+	perf_enabled = enable;
+	
+	if (!enable)
+	{
+		NX_LOG("PerfCount: stopped, after %d frames\n", pc.nframes);
+		close_counters();
+		return 0;
+	}
+	
+	Reset();
+	
+	if (open_counters())
+	{
+		NX_ERR("PerfCount: no performance counters are available; only timing the zones\n");
+		return 1;
+	}
+	
+	NX_LOG("PerfCount: counting %d of %d counters per zone\n", pc.ncounters, PC_NUM_COUNTERS);
+	return 0;
+}
+
+// returns how many of the counters are being read
+int PerfCount::NumCounters(void)
+{
+	return perf_enabled ? pc.ncounters : 0;
+}
+
+void PerfCount::Reset(void)
+{
+	memset(pc.total, 0, sizeof(pc.total));
+	memset(pc.total_usec, 0, sizeof(pc.total_usec));
+	pc.nframes = 0;
+}
+
+/*
+void c------------------------------() {}
+*/
+
+void PerfCount::BeginZone(int zone)
+{
+	if (pc.leader != -1)
+		read_counters(pc.start[zone]);
+	
+	pc.start_usec[zone] = retro_get_usec();
+}
+
+void PerfCount::EndZone(int zone)
+{
+uint64_t now[PC_NUM_COUNTERS];
+
+	pc.total_usec[zone] += (retro_get_usec() - pc.start_usec[zone]);
+	
+	if (pc.leader == -1 || read_counters(now))
+		return;
+	
+	// scaled values from a multiplexed group can go backwards a little
+	for(int i=0;i<PC_NUM_COUNTERS;i++)
+	{
+		if (now[i] > pc.start[zone][i])
+			pc.total[zone][i] += (now[i] - pc.start[zone][i]);
+	}
+}
+
+void PerfCount::EndFrame(void)
+{
+	pc.nframes++;
+}
+
+/*
+void c------------------------------() {}
+*/
+
+// writes the per-frame averages of each zone out to perf.txt.
+bool PerfCount::Dump(void)
+{
+char path[MAXPATHLEN];
+int i;
+
+	retro_create_path_string(path, sizeof(path), g_dir, PERFCOUNT_FNAME);
+	
+	FILE *fp = fopen(path, "wb");
+	if (!fp)
+	{
+		NX_ERR("PerfCount::Dump: couldn't open '%s'\n", path);
+		return 1;
+	}
+	
+	int nframes = MAX(pc.nframes, 1);
+	
+	fprintf(fp, "performance counters over %d frames; counting", pc.nframes);
+	for(i=0;i<PC_NUM_COUNTERS;i++)
+	{
+		if (pc.index[i] >= 0)
+			fprintf(fp, " [%s]", counter_names[i]);
+	}
+	
+	if (pc.leader == -1)
+		fprintf(fp, " nothing, only timing");
+	
+	fprintf(fp, "\nper frame, with misses per thousand instructions:\n\n");
+	fprintf(fp, "zone       usec  kcycles   kinstr   ipc  l1d/ki  llc/ki   br/ki  bound by\n");
+	
+	for(int zone=0;zone<HZ_NUM_ZONES;zone++)
+	{
+		uint64_t *t = pc.total[zone];
+		
+		fprintf(fp, "%-8s %6.1f", Hitch::ZoneName(zone), (double)pc.total_usec[zone] / nframes);
+		fprintf(fp, " %8s", counter_column(t, PC_CYCLES, nframes / 1000.0f));
+		fprintf(fp, " %8s", counter_column(t, PC_INSTRUCTIONS, nframes / 1000.0f));
+		
+		if (pc.index[PC_CYCLES] >= 0 && pc.index[PC_INSTRUCTIONS] >= 0 && t[PC_CYCLES])
+			fprintf(fp, " %5.2f", (double)t[PC_INSTRUCTIONS] / (double)t[PC_CYCLES]);
+		else
+			fprintf(fp, " %5s", "-");
+		
+		float ki = t[PC_INSTRUCTIONS] / 1000.0f;
+		fprintf(fp, " %7s", counter_column(t, PC_L1D_MISSES, ki));
+		fprintf(fp, " %7s", counter_column(t, PC_LLC_MISSES, ki));
+		fprintf(fp, " %7s", counter_column(t, PC_BRANCH_MISSES, ki));
+		fprintf(fp, "  %s\n", bound_by(t));
+	}
+	
+	fclose(fp);
+	return 0;
+}
+
+// formats a counter divided by "per" for the dump, or "-" if it can't be
+static const char *counter_column(uint64_t *t, int counter, float per)
+{
+static char buffer[16];
+
+	if (pc.index[counter] < 0 || per <= 0)
+		return "-";
+	
+	snprintf(buffer, sizeof(buffer), "%.1f", (double)t[counter] / per);
+	return buffer;
+}
+
+// a rough guess at what's holding a zone back, from the misses per thousand
+// instructions. it's only a hint at where to look first; the numbers are there.
+static const char *bound_by(uint64_t *t)
+{
+	if (pc.index[PC_INSTRUCTIONS] < 0 || t[PC_INSTRUCTIONS] < 1000)
+		return "-";
+	
+	double ki = t[PC_INSTRUCTIONS] / 1000.0;
+	
+	if (pc.index[PC_LLC_MISSES] >= 0 && (t[PC_LLC_MISSES] / ki) >= 1.0)
+		return "memory";
+	
+	if (pc.index[PC_L1D_MISSES] >= 0 && (t[PC_L1D_MISSES] / ki) >= 20.0)
+		return "cache";
+	
+	if (pc.index[PC_BRANCH_MISSES] >= 0 && (t[PC_BRANCH_MISSES] / ki) >= 5.0)
+		return "branches";
+	
+	return "compute";
+}
+
+/*
+void c------------------------------() {}
+*/
+
+#ifdef PERFCOUNT_SUPPORTED
+
+static const struct
+{
+	uint32_t type;
+	uint64_t config;
+}
+counter_events[] =
+{
+	{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+	{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+	{ PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | \
+							(PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+	{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+	{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES }
+};
+
+// the counters are opened as a single group, so they're all read at once and
+// cover exactly the same stretch of code. any which the CPU doesn't have, or
+// which won't fit in the group alongside the others, are just left out.
+static bool open_counters(void)
+{
+struct perf_event_attr attr;
+
+	pc.leader = -1;
+	pc.ncounters = 0;
+	
+	for(int i=0;i<PC_NUM_COUNTERS;i++)
+	{
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = counter_events[i].type;
+		attr.config = counter_events[i].config;
+		attr.disabled = (pc.leader == -1);
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | \
+							PERF_FORMAT_TOTAL_TIME_RUNNING;
+		
+		pc.fds[i] = syscall(__NR_perf_event_open, &attr, 0, -1, pc.leader, 0);
+		if (pc.fds[i] < 0)
+		{
+			NX_LOG("PerfCount: counter '%s' isn't available\n", counter_names[i]);
+			pc.fds[i] = -1;
+			pc.index[i] = -1;
+			continue;
+		}
+		
+		if (pc.leader == -1)
+			pc.leader = pc.fds[i];
+		
+		pc.index[i] = pc.ncounters++;
+	}
+	
+	if (pc.leader == -1)
+		return 1;
+	
+	ioctl(pc.leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	ioctl(pc.leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	return 0;
+}
+
+static void close_counters(void)
+{
+	for(int i=0;i<PC_NUM_COUNTERS;i++)
+	{
+		if (pc.fds[i] != -1)
+			close(pc.fds[i]);
+		
+		pc.fds[i] = -1;
+	}
+	
+	pc.leader = -1;
+	pc.ncounters = 0;
+}
+
+// reads the current value of each counter. if the kernel had to share the
+// hardware with something else and only counted for part of the time, the
+// values are scaled up to cover all of it.
+static bool read_counters(uint64_t *values)
+{
+uint64_t buffer[3 + PC_NUM_COUNTERS];
+
+	ssize_t size = read(pc.leader, buffer, sizeof(buffer));
+	if (size < (ssize_t)((3 + pc.ncounters) * sizeof(uint64_t)))
+	{
+		memset(values, 0, PC_NUM_COUNTERS * sizeof(uint64_t));
+		return 1;
+	}
+	
+	uint64_t enabled = buffer[1];
+	uint64_t running = buffer[2];
+	
+	for(int i=0;i<PC_NUM_COUNTERS;i++)
+	{
+		if (pc.index[i] < 0)
+		{
+			values[i] = 0;
+			continue;
+		}
+		
+		uint64_t value = buffer[3 + pc.index[i]];
+		if (running && running < enabled)
+			value = (uint64_t)((double)value * enabled / running);
+		
+		values[i] = value;
+	}
+	
+	return 0;
+}
+
+#else
+
+// no perf_event_open on this system; the zones are just timed
+static bool open_counters(void)
+{
+	for(int i=0;i<PC_NUM_COUNTERS;i++)
+	{
+		pc.fds[i] = -1;
+		pc.index[i] = -1;
+	}
+	
+	pc.leader = -1;
+	pc.ncounters = 0;
+	return 1;
+}
+
+static void close_counters(void)
+{
+}
+
+static bool read_counters(uint64_t *values)
+{
+	memset(values, 0, PC_NUM_COUNTERS * sizeof(uint64_t));
+	return 1;
+}
+
+#endif
@@ -0,0 +1,50 @@
+
+#ifndef _PERFCOUNT_H
+#define _PERFCOUNT_H
+
+// hardware performance counters for the hitch recorder's zones. the time a zone
+// takes doesn't say why it takes it; with the counters on, each zone also adds up
+// the cycles, instructions, cache misses and branch misses the CPU counted while
+// it ran, so that on a given board it can be told whether say the map drawing is
+// waiting on memory or just doing too much.
+//
+// they're read with perf_event_open, so only on Linux (and Android), and only where
+// the kernel lets us; counters the CPU or kernel doesn't have are left out, and if
+// none of them can be opened the zones are just timed.
+//
+// they're off by default, as reading them costs a syscall at each end of each zone.
+// turn them on from the console with "perf on", or by setting NX_PERF=1;
+// "perf dump" writes the totals for each zone out to perf.txt.
+
+#define PERFCOUNT_FNAME			"perf.txt"
+
+enum PerfCounters
+{
+	PC_CYCLES,
+	PC_INSTRUCTIONS,
+	PC_L1D_MISSES,			// L1 data cache read misses
+	PC_LLC_MISSES,			// last-level cache misses
+	PC_BRANCH_MISSES,
+	
+	PC_NUM_COUNTERS
+};
+
+// checked by the hitch recorder before going into the counters
+extern bool perf_enabled;
+
+namespace PerfCount
+{
+	void Init(void);
+	
+	bool SetEnabled(bool enable);
+	int NumCounters(void);
+	void Reset(void);
+	
+	void BeginZone(int zone);
+	void EndZone(int zone);
+	void EndFrame(void);
+	
+	bool Dump(void);
+};
+
+#endif
@@ -127,6 +127,7 @@ bool profile_save(const char *pfname, Profile *file)
    int i;
 
 	NX_LOG("Writing saved game to %s...\n", pfname);
+	int64_t start = Hitch::Now();
 
 	fp = fopen(pfname, "wb");
 	if (!fp)
@@ -218,6 +219,7 @@ bool profile_save(const char *pfname, Profile *file)
 	fbooleanflush(fp);
 	
 	fclose(fp);
+	Hitch::Event(HE_PROFILE_SAVE, start, pfname);
 	return 0;
 }
 
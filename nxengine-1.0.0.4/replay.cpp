@@ -3,6 +3,8 @@
 #include "nx.h"
 #include "replay.h"
 #include "profile.h"
+#include "sound/audiocheck.h"
+#include "verify.h"
 #include "replay.fdh"
 using namespace Replay;
 
@@ -10,6 +12,9 @@ using namespace Replay;
 static ReplayRecording rec;
 static ReplayPlaying play;
 
+// runs recorded since the last flush. it's kept out of rec, as that gets memset.
+static DBuffer rec_log;
+
 static int next_ffwdto = 0;
 static int next_stopat = 0;
 static bool next_accel = false;
@@ -54,9 +59,12 @@ Profile profile;
 	seedrand(rec.hdr.randseed);
 	
 	fputl('MARK', fp);
-	rec.fb.SetFile(fp);
-	rec.fb.SetBufferSize(256);
-	rec.fb.Dump();
+	
+	rec.datapos = ftell(fp);
+	rec_log.Clear();
+	
+	// put the end marker on straight away, so the file's a valid (empty) replay
+	flush_record();
 	return 0;
 }
 
@@ -65,23 +73,46 @@ bool Replay::end_record()
 	if (!IsRecording())
 		return 1;
 	
-	// flush final RLE run
-	write_record(rec.lastkeys, rec.runlength, &rec.fb);
-	rec.runlength = 0;
-	rec.fb.Flush();
-	rec.fb.SetFile(NULL);
+	flush_record();
+	fclose(rec.fp);
+	
+	NX_LOG("end_record(): wrote %d frames\n", rec.hdr.total_frames);
+	memset(&rec, 0, sizeof(rec));
+	return 0;
+}
+
+// writes out the input recorded since the last flush, followed by the end marker,
+// and updates total_frames in the header to match. that leaves the file a complete
+// replay at every flush, so should the game go down before end_record is reached,
+// everything up until the last stage change still plays back.
+static void flush_record(void)
+{
+	int64_t start = Hitch::Now();
+	
+	// cut off the run in progress here; it carries on as a new run afterwards
+	if (rec.runlength != 0)
+	{
+		write_record(rec.lastkeys, rec.runlength, &rec_log);
+		rec.runlength = 0;
+	}
+	
+	fseek(rec.fp, rec.datapos, SEEK_SET);
+	if (rec_log.Length())
+	{
+		fwrite(rec_log.Data(), rec_log.Length(), 1, rec.fp);
+		rec.datapos += rec_log.Length();
+		rec_log.Clear();
+	}
 	
+	// the end marker is written over by the next flush
 	fputc('!', rec.fp);
 	fputl('STOP', rec.fp);
 	
-	// go back and save the header again so we have total_frames correct.
 	fseek(rec.fp, PROFILE_LENGTH, SEEK_SET);
 	fwrite(&rec.hdr, sizeof(ReplayHeader), 1, rec.fp);
-	fclose(rec.fp);
+	fflush(rec.fp);
 	
-	NX_LOG("end_record(): wrote %d frames\n", rec.hdr.total_frames);
-	memset(&rec, 0, sizeof(rec));
-	return 0;
+	Hitch::Event(HE_REPLAY_FLUSH, start);
 }
 
 /*
@@ -124,6 +155,10 @@ Profile profile;
 	replay_settings.sound_enabled = normal_settings.sound_enabled;
 	replay_settings.music_enabled = normal_settings.music_enabled;
 	
+	// must be done before game_load, which starts the replay's music
+	audiocheck_begin(fname);
+	Verify::Begin(fname);
+	
 	game_load(&profile);
 	seedrand(play.hdr.randseed);
 	
@@ -150,6 +185,8 @@ Profile profile;
 
 bool Replay::end_playback()
 {
+	audiocheck_end();
+	Verify::End();
 	if (!IsPlaying()) return 1;
 	
 	fclose(play.fp);
@@ -197,8 +234,11 @@ void Replay::run_record()
 	{
 		if (rec.runlength != 0)
 		{
-			write_record(rec.lastkeys, rec.runlength, &rec.fb);
+			write_record(rec.lastkeys, rec.runlength, &rec_log);
 			rec.runlength = 0;
+			
+			if (rec_log.Length() >= REPLAY_FLUSH_SIZE)
+				flush_record();
 		}
 		
 		rec.lastkeys = keys;
@@ -217,6 +257,13 @@ static void Replay::run_playback()
 		return;
 	}
 	
+	// there's no point playing out the rest once it's gone wrong
+	if (Verify::OnFrame(play.elapsed_frames))
+	{
+		end_playback();
+		return;
+	}
+	
 	// RLE decoding
 	if (play.runlength == 0)
 	{
@@ -264,13 +311,13 @@ static void Replay::run_playback()
 void c------------------------------() {}
 */
 
-static void write_record(uint32_t keys, uint32_t runlength, FileBuffer *fb)
+static void write_record(uint32_t keys, uint32_t runlength, DBuffer *log)
 {
-	fb->Write8('[');
-	fb->Write32(keys);
-	fb->Write8(':');
-	fb->Write32(runlength);
-	fb->Write8(']');
+	log->Append8('[');
+	log->Append32(keys);
+	log->Append8(':');
+	log->Append32(runlength);
+	log->Append8(']');
 }
 
 static bool read_record(uint32_t *keys, uint32_t *runlength, FILE *fp)
@@ -371,6 +418,14 @@ void Replay::OnGameStarting()
 }
 
 
+// called from main between stages. there's a load going on then anyway,
+// so it's a good time to write out what's been recorded so far.
+void Replay::OnStageExit()
+{
+	if (IsRecording())
+		flush_record();
+}
+
 bool Replay::begin_record_next()
 {
 	int slot = GetAvailableSlot();
@@ -480,7 +535,7 @@ const char *GetReplayName(int slotno, char *buffer)
 #else
    slash = '/';
 #endif
-	snprintf(buffer, sizeof(buffer), "replay%crep%d.dat", slash, slotno);
+	snprintf(buffer, MAXPATHLEN, "replay%crep%d.dat", slash, slotno);
 	return buffer;
 }
 
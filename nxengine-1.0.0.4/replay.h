@@ -2,9 +2,13 @@
 #ifndef _REPLAY_H
 #define _REPLAY_H
 
-#include "common/FileBuffer.h"
 #define MAX_REPLAYS				8	// how many automatic replays to save
 
+// while recording, input is kept in memory and only written out between stages
+// (and when recording ends), so that it never costs any I/O during gameplay.
+// if that much piles up in one stage though, it's written out right away.
+#define REPLAY_FLUSH_SIZE		(256 * 1024)
+
 #define REC_OK		0
 #define REC_ERR		1
 #define REC_END		2
@@ -22,10 +26,10 @@ struct ReplayHeader
 struct ReplayRecording
 {
 	ReplayHeader hdr;
-	FileBuffer fb;
 	
 	uint32_t lastkeys;
 	uint32_t runlength;
+	long datapos;		// where in the file the next runs are written
 	FILE *fp;
 };
 
@@ -72,6 +76,7 @@ namespace Replay
 	void close();
 	
 	void OnGameStarting();
+	void OnStageExit();
 	bool begin_record_next();
 	
 	bool IsRecording();
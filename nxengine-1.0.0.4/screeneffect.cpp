@@ -62,6 +62,7 @@ void SE_Starflash::Draw(void)
 SE_Starflash * const &star = this;
 int scr_x1, scr_y1, scr_x2, scr_y2;
 int rel_x, rel_y;
+bool visible;
 
 	if (state == 0)
 	{	// flash getting bigger
@@ -79,6 +80,9 @@ int rel_x, rel_y;
 		}
 	}
 	
+	// the flash still runs it's course if the governor has it hidden
+	visible = (Governor::Level() < DETAIL_LOW);
+	
 	// draw the flash
 	rel_x = (star->centerx - map.displayed_xscroll);
 	rel_y = (star->centery - map.displayed_yscroll);
@@ -86,14 +90,14 @@ int rel_x, rel_y;
 	// draw a horizontal bar
 	scr_y1 = (rel_y - star->size) >> CSF;
 	scr_y2 = (rel_y + star->size) >> CSF;
-	FillRect(0, scr_y1, SCREEN_WIDTH, scr_y2, 255, 255, 255);
+	if (visible) FillRect(0, scr_y1, SCREEN_WIDTH, scr_y2, 255, 255, 255);
 	
 	if (star->state == 0)
 	{
 		// draw a vertical bar
 		scr_x1 = (rel_x - starflash.size) >> CSF;
 		scr_x2 = (rel_x + starflash.size) >> CSF;
-		FillRect(scr_x1, 0, scr_x2, SCREEN_HEIGHT, 255, 255, 255);
+		if (visible) FillRect(scr_x1, 0, scr_x2, SCREEN_HEIGHT, 255, 255, 255);
 		
 		// once it's big enough, switch to making it smaller
 		if (star->size > (1280<<CSF))
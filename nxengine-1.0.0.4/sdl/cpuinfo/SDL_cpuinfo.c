@@ -41,6 +41,10 @@
 #define CPU_HAS_SSE	0x00000040
 #define CPU_HAS_SSE2	0x00000080
 #define CPU_HAS_ALTIVEC	0x00000100
+#define CPU_HAS_SSE41	0x00000200
+#define CPU_HAS_AVX2	0x00000400
+#define CPU_HAS_NEON	0x00000800
+#define CPU_HAS_PCLMUL	0x00001000
 
 #if SDL_ALTIVEC_BLITTERS && HAVE_SETJMP && !__MACOSX__
 /* This is the brute force way of detecting instruction sets...
@@ -300,6 +304,68 @@ done:
 	return features;
 }
 
+/* Runs CPUID with the given leaf and subleaf, for the newer feature bits
+   which the functions above don't return. regs gets eax, ebx, ecx, edx. */
+static __inline__ void CPU_cpuid(int leaf, int subleaf, int regs[4])
+{
+	regs[0] = regs[1] = regs[2] = regs[3] = 0;
+#if defined(__GNUC__) && defined(i386)
+	/* ebx may be the PIC register, so it's swapped out rather than clobbered */
+	__asm__ (
+"        xchgl   %%ebx,%%esi                                           \n"
+"        cpuid                                                         \n"
+"        xchgl   %%ebx,%%esi                                           \n"
+	: "=a" (regs[0]), "=S" (regs[1]), "=c" (regs[2]), "=d" (regs[3])
+	: "a" (leaf), "c" (subleaf)
+	);
+#elif defined(__GNUC__) && defined(__x86_64__)
+	__asm__ (
+"        cpuid                                                         \n"
+	: "=a" (regs[0]), "=b" (regs[1]), "=c" (regs[2]), "=d" (regs[3])
+	: "a" (leaf), "c" (subleaf)
+	);
+#elif defined(_MSC_VER) && defined(_M_IX86)
+	int a, b, c, d;
+	__asm {
+        mov     eax, leaf
+        mov     ecx, subleaf
+        push    ebx
+        cpuid
+        mov     esi, ebx
+        pop     ebx
+        mov     a, eax
+        mov     b, esi
+        mov     c, ecx
+        mov     d, edx
+	}
+	regs[0] = a; regs[1] = b; regs[2] = c; regs[3] = d;
+#endif
+}
+
+/* Returns the OS-enabled register state (XCR0), which says whether it
+   will save the YMM registers; only valid if CPUID reports OSXSAVE. */
+static __inline__ Uint32 CPU_xgetbv(void)
+{
+	Uint32 xcr0 = 0;
+#if defined(__GNUC__) && (defined(i386) || defined(__x86_64__))
+	Uint32 hi;
+	__asm__ (
+"        .byte   0x0f, 0x01, 0xd0    # xgetbv                          \n"
+	: "=a" (xcr0), "=d" (hi)
+	: "c" (0)
+	);
+#elif defined(_MSC_VER) && defined(_M_IX86)
+	__asm {
+        xor     ecx, ecx
+        _emit   0x0f
+        _emit   0x01
+        _emit   0xd0
+        mov     xcr0, eax
+	}
+#endif
+	return xcr0;
+}
+
 static __inline__ int CPU_haveRDTSC(void)
 {
 	if ( CPU_haveCPUID() ) {
@@ -356,6 +422,66 @@ static __inline__ int CPU_haveSSE2(void)
 	return 0;
 }
 
+static __inline__ int CPU_haveSSE41(void)
+{
+	if ( CPU_haveCPUID() ) {
+		int regs[4];
+		CPU_cpuid(0, 0, regs);
+		if ( regs[0] >= 1 ) {
+			CPU_cpuid(1, 0, regs);
+			return (regs[2] & 0x00080000);
+		}
+	}
+	return 0;
+}
+
+static __inline__ int CPU_haveAVX2(void)
+{
+	if ( CPU_haveCPUID() ) {
+		int regs[4];
+		CPU_cpuid(0, 0, regs);
+		if ( regs[0] >= 7 ) {
+			/* the CPU has to have AVX, and the OS has to
+			   be saving the full YMM state for us */
+			CPU_cpuid(1, 0, regs);
+			if ( (regs[2] & 0x18000000) != 0x18000000 ) {
+				return 0;
+			}
+			if ( (CPU_xgetbv() & 0x6) != 0x6 ) {
+				return 0;
+			}
+			CPU_cpuid(7, 0, regs);
+			return (regs[1] & 0x00000020);
+		}
+	}
+	return 0;
+}
+
+static __inline__ int CPU_havePCLMUL(void)
+{
+	if ( CPU_haveCPUID() ) {
+		int regs[4];
+		CPU_cpuid(0, 0, regs);
+		if ( regs[0] >= 1 ) {
+			CPU_cpuid(1, 0, regs);
+			return (regs[2] & 0x00000002);
+		}
+	}
+	return 0;
+}
+
+/* NEON is always there on 64-bit ARM; on 32-bit ARM we only have kernels
+   for it when the compiler was told it can use it, which it may then do
+   anywhere, so there's nothing more to be learned by probing at runtime. */
+static __inline__ int CPU_haveNEON(void)
+{
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON) || defined(__ARM_NEON__)
+	return 1;
+#else
+	return 0;
+#endif
+}
+
 static __inline__ int CPU_haveAltiVec(void)
 {
 	volatile int altivec = 0;
@@ -411,6 +537,18 @@ static Uint32 SDL_GetCPUFeatures(void)
 		if ( CPU_haveAltiVec() ) {
 			SDL_CPUFeatures |= CPU_HAS_ALTIVEC;
 		}
+		if ( CPU_haveSSE41() ) {
+			SDL_CPUFeatures |= CPU_HAS_SSE41;
+		}
+		if ( CPU_haveAVX2() ) {
+			SDL_CPUFeatures |= CPU_HAS_AVX2;
+		}
+		if ( CPU_haveNEON() ) {
+			SDL_CPUFeatures |= CPU_HAS_NEON;
+		}
+		if ( CPU_havePCLMUL() ) {
+			SDL_CPUFeatures |= CPU_HAS_PCLMUL;
+		}
 	}
 	return SDL_CPUFeatures;
 }
@@ -479,6 +617,38 @@ SDL_bool SDL_HasAltiVec(void)
 	return SDL_FALSE;
 }
 
+SDL_bool SDL_HasSSE41(void)
+{
+	if ( SDL_GetCPUFeatures() & CPU_HAS_SSE41 ) {
+		return SDL_TRUE;
+	}
+	return SDL_FALSE;
+}
+
+SDL_bool SDL_HasAVX2(void)
+{
+	if ( SDL_GetCPUFeatures() & CPU_HAS_AVX2 ) {
+		return SDL_TRUE;
+	}
+	return SDL_FALSE;
+}
+
+SDL_bool SDL_HasNEON(void)
+{
+	if ( SDL_GetCPUFeatures() & CPU_HAS_NEON ) {
+		return SDL_TRUE;
+	}
+	return SDL_FALSE;
+}
+
+SDL_bool SDL_HasPCLMUL(void)
+{
+	if ( SDL_GetCPUFeatures() & CPU_HAS_PCLMUL ) {
+		return SDL_TRUE;
+	}
+	return SDL_FALSE;
+}
+
 #ifdef TEST_MAIN
 
 #include <stdio.h>
@@ -493,6 +663,10 @@ int main()
 	printf("SSE: %d\n", SDL_HasSSE());
 	printf("SSE2: %d\n", SDL_HasSSE2());
 	printf("AltiVec: %d\n", SDL_HasAltiVec());
+	printf("SSE4.1: %d\n", SDL_HasSSE41());
+	printf("AVX2: %d\n", SDL_HasAVX2());
+	printf("NEON: %d\n", SDL_HasNEON());
+	printf("PCLMUL: %d\n", SDL_HasPCLMUL());
 	return 0;
 }
 
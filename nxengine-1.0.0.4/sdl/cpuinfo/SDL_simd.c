@@ -0,0 +1,435 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* Runtime selection of the vectorized blit, fill and mix kernels,
+   and the scalar reference versions of them. */
+
+#include "SDL.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_simd_c.h"
+
+/*
+ * The scalar reference kernels
+ */
+
+void SDL_Expand8to16Key_C(const Uint8 *src, Uint16 *dst, int width,
+                          const Uint16 *palmap, Uint8 key)
+{
+	while ( width-- ) {
+		if ( *src != key ) {
+			*dst = palmap[*src];
+		}
+		src++;
+		dst++;
+	}
+}
+
+void SDL_Expand8to16_C(const Uint8 *src, Uint16 *dst, int width,
+                       const Uint16 *palmap)
+{
+	while ( width-- ) {
+		*dst++ = palmap[*src++];
+	}
+}
+
+void SDL_Copy16Key_C(const Uint16 *src, Uint16 *dst, int width, Uint16 key)
+{
+	while ( width-- ) {
+		if ( *src != key ) {
+			*dst = *src;
+		}
+		src++;
+		dst++;
+	}
+}
+
+void SDL_Fill16_C(Uint16 *dst, int width, Uint16 color)
+{
+	Uint32 cc = (Uint32)color << 16 | color;
+
+	if ( ((uintptr_t)dst & 3) && width ) {
+		*dst++ = color;
+		width--;
+	}
+	if ( width >> 1 ) {
+		SDL_memset4(dst, cc, width >> 1);
+	}
+	if ( width & 1 ) {
+		dst[width - 1] = color;
+	}
+}
+
+void SDL_Mix16_C(Sint16 *dst, const Sint16 *src, int count, int volume)
+{
+	while ( count-- ) {
+		Sint32 sample = *dst + (Sint32)*src++ * volume / 256;
+		if ( sample > 0x7fff ) {
+			sample = 0x7fff;
+		} else if ( sample < -0x8000 ) {
+			sample = -0x8000;
+		}
+		*dst++ = (Sint16)sample;
+	}
+}
+
+const SDL_SIMDKernels SDL_SIMD_ScalarKernels = {
+	SDL_Expand8to16Key_C,
+	SDL_Expand8to16_C,
+	SDL_Copy16Key_C,
+	SDL_Fill16_C,
+	SDL_Mix16_C
+};
+
+/*
+ * Path selection
+ */
+
+static const char *path_names[SDL_SIMD_NUM_PATHS] = {
+	"scalar", "sse2", "sse4.1", "avx2", "neon"
+};
+
+static SDL_SIMDPath current_path = SDL_SIMD_AUTO;
+static const SDL_SIMDKernels *current_kernels = NULL;
+
+static SDL_SIMDShadowFunc shadow_func = NULL;
+static const SDL_SIMDKernels SDL_SIMD_ShadowKernels;
+
+const SDL_SIMDKernels *SDL_GetSIMDKernelsFor(SDL_SIMDPath path)
+{
+	switch (path) {
+	    case SDL_SIMD_SCALAR:
+		return &SDL_SIMD_ScalarKernels;
+	    case SDL_SIMD_SSE2:
+		return SDL_HasSSE2() ? SDL_SIMD_SSE2Kernels : NULL;
+	    case SDL_SIMD_SSE41:
+		return SDL_HasSSE41() ? SDL_SIMD_SSE41Kernels : NULL;
+	    case SDL_SIMD_AVX2:
+		return SDL_HasAVX2() ? SDL_SIMD_AVX2Kernels : NULL;
+	    case SDL_SIMD_NEON:
+		return SDL_HasNEON() ? SDL_SIMD_NEONKernels : NULL;
+	    default:
+		return NULL;
+	}
+}
+
+SDL_SIMDPath SDL_SetSIMDPath(SDL_SIMDPath path)
+{
+	int i;
+
+	if ( path > SDL_SIMD_AUTO && path < SDL_SIMD_NUM_PATHS ) {
+		current_kernels = SDL_GetSIMDKernelsFor(path);
+		if ( current_kernels ) {
+			current_path = path;
+			return current_path;
+		}
+	}
+
+	/* the paths are in order of preference */
+	for ( i = SDL_SIMD_NUM_PATHS-1; i >= SDL_SIMD_SCALAR; --i ) {
+		current_kernels = SDL_GetSIMDKernelsFor((SDL_SIMDPath)i);
+		if ( current_kernels ) {
+			current_path = (SDL_SIMDPath)i;
+			break;
+		}
+	}
+	return current_path;
+}
+
+SDL_SIMDPath SDL_GetSIMDPath(void)
+{
+	if ( !current_kernels ) {
+		SDL_SIMDPath path = SDL_SIMD_AUTO;
+		const char *override = SDL_getenv("SDL_SIMD");
+		int i;
+
+		if ( override ) {
+			for ( i = 0; i < SDL_SIMD_NUM_PATHS; ++i ) {
+				if ( SDL_strcasecmp(override, path_names[i]) == 0 ) {
+					path = (SDL_SIMDPath)i;
+				}
+			}
+		}
+		SDL_SetSIMDPath(path);
+	}
+	return current_path;
+}
+
+const SDL_SIMDKernels *SDL_GetSIMDKernels(void)
+{
+	if ( !current_kernels ) {
+		SDL_GetSIMDPath();
+	}
+	if ( shadow_func && current_path != SDL_SIMD_SCALAR ) {
+		return &SDL_SIMD_ShadowKernels;
+	}
+	return current_kernels;
+}
+
+const char *SDL_GetSIMDPathName(SDL_SIMDPath path)
+{
+	if ( path >= SDL_SIMD_SCALAR && path < SDL_SIMD_NUM_PATHS ) {
+		return path_names[path];
+	}
+	return "auto";
+}
+
+/*
+ * Verification against the scalar reference
+ */
+
+#define VERIFY_LEN	77	/* odd, so every path has a tail to deal with */
+
+static const int verify_volumes[8] = { 0, 1, 64, 100, 127, 128, 255, 256 };
+
+static void reset_rows(Uint16 *a, Uint16 *b)
+{
+	int i;
+	for ( i = 0; i <= VERIFY_LEN; ++i ) {
+		a[i] = b[i] = (Uint16)(i * 31);
+	}
+}
+
+int SDL_VerifySIMDKernels(SDL_SIMDPath path)
+{
+	const SDL_SIMDKernels *ref = &SDL_SIMD_ScalarKernels;
+	const SDL_SIMDKernels *k = SDL_GetSIMDKernelsFor(path);
+	Uint16 palmap[256 + 2];
+	Uint8 src8[VERIFY_LEN + 1];
+	Uint16 src16[VERIFY_LEN + 1];
+	Sint16 samples[VERIFY_LEN + 1];
+	Uint16 a[VERIFY_LEN + 1], b[VERIFY_LEN + 1];
+	Sint16 sa[VERIFY_LEN + 1], sb[VERIFY_LEN + 1];
+	Uint32 seed = 0x2545F491;
+	int failures = 0;
+	int pattern, offs, i;
+
+	if ( !k ) {
+		return 0;
+	}
+
+	for ( i = 0; i < 256 + 2; ++i ) {
+		palmap[i] = (Uint16)(i * 0x9E37 + 0x79B9);
+	}
+
+	for ( pattern = 0; pattern < 8; ++pattern ) {
+		/* pattern 0 is all the colorkey, 1 has none of it,
+		   and the rest are a random mix of the two */
+		for ( i = 0; i <= VERIFY_LEN; ++i ) {
+			seed = seed * 1103515245 + 12345;
+			src8[i] = (Uint8)(seed >> 16);
+			src16[i] = (Uint16)(seed >> 8);
+			samples[i] = (Sint16)(seed >> 12);
+			if ( pattern == 0 || (pattern > 1 && (seed & 0x80000000)) ) {
+				src8[i] = 0x00;
+				src16[i] = 0xF81F;
+			} else if ( src8[i] == 0x00 ) {
+				src8[i] = 0x01;
+			}
+			if ( pattern == 7 ) {
+				samples[i] = (seed & 1) ? 0x7fff : -0x8000;
+			}
+		}
+
+		/* try each starting alignment */
+		for ( offs = 0; offs < 2; ++offs ) {
+			int len = VERIFY_LEN - offs;
+
+			reset_rows(a, b);
+			ref->Expand8to16Key(src8 + offs, a + offs, len, palmap, 0x00);
+			k->Expand8to16Key(src8 + offs, b + offs, len, palmap, 0x00);
+			failures += (SDL_memcmp(a, b, sizeof(a)) != 0);
+
+			reset_rows(a, b);
+			ref->Expand8to16(src8 + offs, a + offs, len, palmap);
+			k->Expand8to16(src8 + offs, b + offs, len, palmap);
+			failures += (SDL_memcmp(a, b, sizeof(a)) != 0);
+
+			reset_rows(a, b);
+			ref->Copy16Key(src16 + offs, a + offs, len, 0xF81F);
+			k->Copy16Key(src16 + offs, b + offs, len, 0xF81F);
+			failures += (SDL_memcmp(a, b, sizeof(a)) != 0);
+
+			reset_rows(a, b);
+			ref->Fill16(a + offs, len, src16[pattern]);
+			k->Fill16(b + offs, len, src16[pattern]);
+			failures += (SDL_memcmp(a, b, sizeof(a)) != 0);
+
+			for ( i = 0; i <= VERIFY_LEN; ++i ) {
+				sa[i] = sb[i] = (Sint16)(src16[i] ^ (i << 9));
+			}
+			ref->Mix16(sa + offs, samples + offs, len, verify_volumes[pattern]);
+			k->Mix16(sb + offs, samples + offs, len, verify_volumes[pattern]);
+			failures += (SDL_memcmp(sa, sb, sizeof(sa)) != 0);
+		}
+	}
+	return failures;
+}
+
+/*
+ * Shadow checking against the scalar reference, during normal use
+ */
+
+static void *shadow_buf = NULL;
+static int shadow_size = 0;
+
+/* returns a copy of the given output row, to run the reference on */
+static void *shadow_copy(const void *dst, int size)
+{
+	if ( size > shadow_size ) {
+		void *buf = SDL_realloc(shadow_buf, size);
+		if ( !buf ) {
+			return NULL;
+		}
+		shadow_buf = buf;
+		shadow_size = size;
+	}
+	SDL_memcpy(shadow_buf, dst, size);
+	return shadow_buf;
+}
+
+/* compares the output of a call with the reference's, and reports the first
+   element which differs. returns the index of it, or -1 if they matched. */
+static int shadow_compare16(const Uint16 *out, const Uint16 *ref, int count)
+{
+	int i;
+	for ( i = 0; i < count; ++i ) {
+		if ( out[i] != ref[i] ) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+static void shadow_report(const char *kernel, const char *fmt, ...)
+{
+	char details[256];
+	va_list ap;
+
+	va_start(ap, fmt);
+	SDL_vsnprintf(details, sizeof(details), fmt, ap);
+	va_end(ap);
+
+	if ( shadow_func ) {
+		shadow_func(kernel, details);
+	}
+}
+
+static void Shadow_Expand8to16Key(const Uint8 *src, Uint16 *dst, int width,
+                                  const Uint16 *palmap, Uint8 key)
+{
+	Uint16 *ref = (Uint16 *)shadow_copy(dst, width * sizeof(Uint16));
+	int i;
+
+	current_kernels->Expand8to16Key(src, dst, width, palmap, key);
+	if ( ref ) {
+		SDL_SIMD_ScalarKernels.Expand8to16Key(src, ref, width, palmap, key);
+		if ( (i = shadow_compare16(dst, ref, width)) >= 0 ) {
+			shadow_report("Expand8to16Key",
+			    "src=%p dst=%p width=%d key=0x%02x: dst[%d] is 0x%04x for src 0x%02x, not 0x%04x",
+			    src, dst, width, key, i, dst[i], src[i], ref[i]);
+		}
+	}
+}
+
+static void Shadow_Expand8to16(const Uint8 *src, Uint16 *dst, int width,
+                               const Uint16 *palmap)
+{
+	Uint16 *ref = (Uint16 *)shadow_copy(dst, width * sizeof(Uint16));
+	int i;
+
+	current_kernels->Expand8to16(src, dst, width, palmap);
+	if ( ref ) {
+		SDL_SIMD_ScalarKernels.Expand8to16(src, ref, width, palmap);
+		if ( (i = shadow_compare16(dst, ref, width)) >= 0 ) {
+			shadow_report("Expand8to16",
+			    "src=%p dst=%p width=%d: dst[%d] is 0x%04x for src 0x%02x, not 0x%04x",
+			    src, dst, width, i, dst[i], src[i], ref[i]);
+		}
+	}
+}
+
+static void Shadow_Copy16Key(const Uint16 *src, Uint16 *dst, int width, Uint16 key)
+{
+	Uint16 *ref = (Uint16 *)shadow_copy(dst, width * sizeof(Uint16));
+	int i;
+
+	current_kernels->Copy16Key(src, dst, width, key);
+	if ( ref ) {
+		SDL_SIMD_ScalarKernels.Copy16Key(src, ref, width, key);
+		if ( (i = shadow_compare16(dst, ref, width)) >= 0 ) {
+			shadow_report("Copy16Key",
+			    "src=%p dst=%p width=%d key=0x%04x: dst[%d] is 0x%04x for src 0x%04x, not 0x%04x",
+			    src, dst, width, key, i, dst[i], src[i], ref[i]);
+		}
+	}
+}
+
+static void Shadow_Fill16(Uint16 *dst, int width, Uint16 color)
+{
+	Uint16 *ref = (Uint16 *)shadow_copy(dst, width * sizeof(Uint16));
+	int i;
+
+	current_kernels->Fill16(dst, width, color);
+	if ( ref ) {
+		SDL_SIMD_ScalarKernels.Fill16(ref, width, color);
+		if ( (i = shadow_compare16(dst, ref, width)) >= 0 ) {
+			shadow_report("Fill16",
+			    "dst=%p width=%d color=0x%04x: dst[%d] is 0x%04x",
+			    dst, width, color, i, dst[i]);
+		}
+	}
+}
+
+static void Shadow_Mix16(Sint16 *dst, const Sint16 *src, int count, int volume)
+{
+	Sint16 *ref = (Sint16 *)shadow_copy(dst, count * sizeof(Sint16));
+	int i;
+
+	current_kernels->Mix16(dst, src, count, volume);
+	if ( ref ) {
+		SDL_SIMD_ScalarKernels.Mix16(ref, src, count, volume);
+		if ( (i = shadow_compare16((Uint16 *)dst, (Uint16 *)ref, count)) >= 0 ) {
+			shadow_report("Mix16",
+			    "dst=%p src=%p count=%d volume=%d: dst[%d] is %d for src %d, not %d",
+			    dst, src, count, volume, i, dst[i], src[i], ref[i]);
+		}
+	}
+}
+
+static const SDL_SIMDKernels SDL_SIMD_ShadowKernels = {
+	Shadow_Expand8to16Key,
+	Shadow_Expand8to16,
+	Shadow_Copy16Key,
+	Shadow_Fill16,
+	Shadow_Mix16
+};
+
+void SDL_SetSIMDShadow(SDL_SIMDShadowFunc func)
+{
+	shadow_func = func;
+	if ( !func && shadow_buf ) {
+		SDL_free(shadow_buf);
+		shadow_buf = NULL;
+		shadow_size = 0;
+	}
+}
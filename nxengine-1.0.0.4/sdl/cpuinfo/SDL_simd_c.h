@@ -0,0 +1,46 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+#include "SDL_config.h"
+
+/* Internal declarations shared by the SIMD kernel implementations */
+
+#include "SDL_simd.h"
+
+/* The scalar reference kernels, which the vector ones also use for
+   whatever is left over at the end of a row. */
+extern void SDL_Expand8to16Key_C(const Uint8 *src, Uint16 *dst, int width,
+                                 const Uint16 *palmap, Uint8 key);
+extern void SDL_Expand8to16_C(const Uint8 *src, Uint16 *dst, int width,
+                              const Uint16 *palmap);
+extern void SDL_Copy16Key_C(const Uint16 *src, Uint16 *dst, int width, Uint16 key);
+extern void SDL_Fill16_C(Uint16 *dst, int width, Uint16 color);
+extern void SDL_Mix16_C(Sint16 *dst, const Sint16 *src, int count, int volume);
+
+/* Kernel tables for each path. The vector files fill in only the kernels
+   which their instruction set can do better; the rest point to the C ones.
+   A path whose table is compiled out has it's pointer set to NULL here. */
+extern const SDL_SIMDKernels SDL_SIMD_ScalarKernels;
+extern const SDL_SIMDKernels *SDL_SIMD_SSE2Kernels;
+extern const SDL_SIMDKernels *SDL_SIMD_SSE41Kernels;
+extern const SDL_SIMDKernels *SDL_SIMD_AVX2Kernels;
+extern const SDL_SIMDKernels *SDL_SIMD_NEONKernels;
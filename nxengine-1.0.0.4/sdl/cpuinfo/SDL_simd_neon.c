@@ -0,0 +1,151 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* ARM NEON versions of the SIMD kernels */
+
+#include "SDL_simd_c.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(__aarch64__)
+
+#include <arm_neon.h>
+
+/* returns 0 if none of the lanes of m are set, 2 if all are, otherwise 1 */
+static __inline__ int mask_state(uint8x16_t m)
+{
+	uint8x8_t all = vand_u8(vget_low_u8(m), vget_high_u8(m));
+	uint8x8_t any = vorr_u8(vget_low_u8(m), vget_high_u8(m));
+	if ( vget_lane_u64(vreinterpret_u64_u8(any), 0) == 0 ) {
+		return 0;
+	}
+	if ( vget_lane_u64(vreinterpret_u64_u8(all), 0) == ~(Uint64)0 ) {
+		return 2;
+	}
+	return 1;
+}
+
+static void Expand8to16Key_NEON(const Uint8 *src, Uint16 *dst, int width,
+                                const Uint16 *palmap, Uint8 key)
+{
+	const uint8x16_t vkey = vdupq_n_u8(key);
+	int i;
+
+	/* the 256-entry palette is too big for a table instruction,
+	   so like the SSE2 version this just skips the colorkey spans */
+	while ( width >= 16 ) {
+		uint8x16_t keyed = vceqq_u8(vld1q_u8(src), vkey);
+		switch ( mask_state(keyed) ) {
+		    case 0:
+			for ( i = 0; i < 16; ++i ) {
+				dst[i] = palmap[src[i]];
+			}
+			break;
+		    case 1:
+			for ( i = 0; i < 16; ++i ) {
+				if ( src[i] != key ) {
+					dst[i] = palmap[src[i]];
+				}
+			}
+			break;
+		}
+		src += 16;
+		dst += 16;
+		width -= 16;
+	}
+	SDL_Expand8to16Key_C(src, dst, width, palmap, key);
+}
+
+static void Copy16Key_NEON(const Uint16 *src, Uint16 *dst, int width, Uint16 key)
+{
+	const uint16x8_t vkey = vdupq_n_u16(key);
+
+	while ( width >= 8 ) {
+		uint16x8_t s = vld1q_u16(src);
+		uint16x8_t keyed = vceqq_u16(s, vkey);
+		switch ( mask_state(vreinterpretq_u8_u16(keyed)) ) {
+		    case 0:
+			vst1q_u16(dst, s);
+			break;
+		    case 1:
+			vst1q_u16(dst, vbslq_u16(keyed, vld1q_u16(dst), s));
+			break;
+		}
+		src += 8;
+		dst += 8;
+		width -= 8;
+	}
+	SDL_Copy16Key_C(src, dst, width, key);
+}
+
+static void Fill16_NEON(Uint16 *dst, int width, Uint16 color)
+{
+	const uint16x8_t c = vdupq_n_u16(color);
+
+	while ( width >= 8 ) {
+		vst1q_u16(dst, c);
+		dst += 8;
+		width -= 8;
+	}
+	SDL_Fill16_C(dst, width, color);
+}
+
+/* divides 32-bit products by 256, truncating toward zero as C does */
+static __inline__ int16x4_t div256_narrow(int32x4_t p)
+{
+	int32x4_t bias = vandq_s32(vshrq_n_s32(p, 31), vdupq_n_s32(255));
+	return vmovn_s32(vshrq_n_s32(vaddq_s32(p, bias), 8));
+}
+
+static void Mix16_NEON(Sint16 *dst, const Sint16 *src, int count, int volume)
+{
+	const int16x4_t vvol = vdup_n_s16((int16_t)volume);
+
+	while ( count >= 8 ) {
+		int16x8_t s = vld1q_s16(src);
+		int32x4_t p0 = vmull_s16(vget_low_s16(s), vvol);
+		int32x4_t p1 = vmull_s16(vget_high_s16(s), vvol);
+		/* with volume <= 256 the scaled samples still fit in 16 bits,
+		   so a saturating add gives the same clamping as the C version */
+		int16x8_t scaled = vcombine_s16(div256_narrow(p0), div256_narrow(p1));
+		vst1q_s16(dst, vqaddq_s16(vld1q_s16(dst), scaled));
+		src += 8;
+		dst += 8;
+		count -= 8;
+	}
+	SDL_Mix16_C(dst, src, count, volume);
+}
+
+static const SDL_SIMDKernels neon_kernels = {
+	Expand8to16Key_NEON,
+	SDL_Expand8to16_C,
+	Copy16Key_NEON,
+	Fill16_NEON,
+	Mix16_NEON
+};
+
+const SDL_SIMDKernels *SDL_SIMD_NEONKernels = &neon_kernels;
+
+#else
+
+const SDL_SIMDKernels *SDL_SIMD_NEONKernels = NULL;
+
+#endif /* __ARM_NEON */
@@ -0,0 +1,330 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* SSE2, SSE4.1 and AVX2 versions of the SIMD kernels. Each function carries
+   it's own target attribute, so this file builds with the default compiler
+   flags and the kernels are only ever run if SDL_cpuinfo says they can be. */
+
+#include "SDL_simd_c.h"
+
+#if (defined(__GNUC__) && (__GNUC__ >= 5 || defined(__clang__)) && \
+     (defined(__i386__) || defined(__x86_64__))) || \
+    (defined(_MSC_VER) && _MSC_VER >= 1800 && (defined(_M_IX86) || defined(_M_X64)))
+#define HAVE_X86_KERNELS 1
+#endif
+
+#if HAVE_X86_KERNELS
+
+#include <immintrin.h>
+
+#if defined(__GNUC__)
+#define TARGET(isa)	__attribute__((target(isa)))
+#else
+#define TARGET(isa)
+#endif
+
+/*
+ * SSE2
+ */
+
+static TARGET("sse2") void Expand8to16Key_SSE2(const Uint8 *src, Uint16 *dst,
+                                              int width, const Uint16 *palmap, Uint8 key)
+{
+	const __m128i vkey = _mm_set1_epi8((char)key);
+	int i, mask;
+
+	/* there's no vector table lookup, but sprites are mostly colorkey,
+	   so finding the spans that can be skipped entirely is the big win */
+	while ( width >= 16 ) {
+		__m128i s = _mm_loadu_si128((const __m128i *)src);
+		mask = _mm_movemask_epi8(_mm_cmpeq_epi8(s, vkey));
+		if ( mask == 0 ) {
+			for ( i = 0; i < 16; ++i ) {
+				dst[i] = palmap[src[i]];
+			}
+		} else if ( mask != 0xffff ) {
+			for ( i = 0; i < 16; ++i ) {
+				if ( !(mask & (1 << i)) ) {
+					dst[i] = palmap[src[i]];
+				}
+			}
+		}
+		src += 16;
+		dst += 16;
+		width -= 16;
+	}
+	SDL_Expand8to16Key_C(src, dst, width, palmap, key);
+}
+
+static TARGET("sse2") void Copy16Key_SSE2(const Uint16 *src, Uint16 *dst,
+                                         int width, Uint16 key)
+{
+	const __m128i vkey = _mm_set1_epi16((short)key);
+
+	while ( width >= 8 ) {
+		__m128i s = _mm_loadu_si128((const __m128i *)src);
+		__m128i keyed = _mm_cmpeq_epi16(s, vkey);
+		int mask = _mm_movemask_epi8(keyed);
+		if ( mask == 0 ) {
+			_mm_storeu_si128((__m128i *)dst, s);
+		} else if ( mask != 0xffff ) {
+			__m128i d = _mm_loadu_si128((const __m128i *)dst);
+			d = _mm_or_si128(_mm_and_si128(keyed, d), _mm_andnot_si128(keyed, s));
+			_mm_storeu_si128((__m128i *)dst, d);
+		}
+		src += 8;
+		dst += 8;
+		width -= 8;
+	}
+	SDL_Copy16Key_C(src, dst, width, key);
+}
+
+static TARGET("sse2") void Fill16_SSE2(Uint16 *dst, int width, Uint16 color)
+{
+	const __m128i c = _mm_set1_epi16((short)color);
+
+	while ( width >= 8 ) {
+		_mm_storeu_si128((__m128i *)dst, c);
+		dst += 8;
+		width -= 8;
+	}
+	SDL_Fill16_C(dst, width, color);
+}
+
+/* divides 32-bit products by 256, truncating toward zero as C does */
+#define DIV256_SSE2(p) \
+	_mm_srai_epi32(_mm_add_epi32(p, _mm_and_si128(_mm_srai_epi32(p, 31), v255)), 8)
+
+static TARGET("sse2") void Mix16_SSE2(Sint16 *dst, const Sint16 *src,
+                                     int count, int volume)
+{
+	const __m128i vvol = _mm_set1_epi16((short)volume);
+	const __m128i v255 = _mm_set1_epi32(255);
+
+	while ( count >= 8 ) {
+		__m128i s = _mm_loadu_si128((const __m128i *)src);
+		__m128i lo = _mm_mullo_epi16(s, vvol);
+		__m128i hi = _mm_mulhi_epi16(s, vvol);
+		__m128i p0 = _mm_unpacklo_epi16(lo, hi);
+		__m128i p1 = _mm_unpackhi_epi16(lo, hi);
+		/* with volume <= 256 the scaled samples still fit in 16 bits,
+		   so a saturating add gives the same clamping as the C version */
+		__m128i scaled = _mm_packs_epi32(DIV256_SSE2(p0), DIV256_SSE2(p1));
+		__m128i d = _mm_loadu_si128((const __m128i *)dst);
+		_mm_storeu_si128((__m128i *)dst, _mm_adds_epi16(d, scaled));
+		src += 8;
+		dst += 8;
+		count -= 8;
+	}
+	SDL_Mix16_C(dst, src, count, volume);
+}
+
+static const SDL_SIMDKernels sse2_kernels = {
+	Expand8to16Key_SSE2,
+	SDL_Expand8to16_C,
+	Copy16Key_SSE2,
+	Fill16_SSE2,
+	Mix16_SSE2
+};
+
+/*
+ * SSE4.1
+ */
+
+static TARGET("sse4.1") void Copy16Key_SSE41(const Uint16 *src, Uint16 *dst,
+                                            int width, Uint16 key)
+{
+	const __m128i vkey = _mm_set1_epi16((short)key);
+
+	while ( width >= 8 ) {
+		__m128i s = _mm_loadu_si128((const __m128i *)src);
+		__m128i keyed = _mm_cmpeq_epi16(s, vkey);
+		if ( _mm_testz_si128(keyed, keyed) ) {
+			_mm_storeu_si128((__m128i *)dst, s);
+		} else if ( !_mm_test_all_ones(keyed) ) {
+			__m128i d = _mm_loadu_si128((const __m128i *)dst);
+			_mm_storeu_si128((__m128i *)dst, _mm_blendv_epi8(s, d, keyed));
+		}
+		src += 8;
+		dst += 8;
+		width -= 8;
+	}
+	SDL_Copy16Key_C(src, dst, width, key);
+}
+
+static TARGET("sse4.1") void Mix16_SSE41(Sint16 *dst, const Sint16 *src,
+                                        int count, int volume)
+{
+	const __m128i vvol = _mm_set1_epi32(volume);
+	const __m128i v255 = _mm_set1_epi32(255);
+
+	while ( count >= 8 ) {
+		__m128i s = _mm_loadu_si128((const __m128i *)src);
+		__m128i p0 = _mm_mullo_epi32(_mm_cvtepi16_epi32(s), vvol);
+		__m128i p1 = _mm_mullo_epi32(_mm_cvtepi16_epi32(_mm_srli_si128(s, 8)), vvol);
+		__m128i scaled = _mm_packs_epi32(DIV256_SSE2(p0), DIV256_SSE2(p1));
+		__m128i d = _mm_loadu_si128((const __m128i *)dst);
+		_mm_storeu_si128((__m128i *)dst, _mm_adds_epi16(d, scaled));
+		src += 8;
+		dst += 8;
+		count -= 8;
+	}
+	SDL_Mix16_C(dst, src, count, volume);
+}
+
+static const SDL_SIMDKernels sse41_kernels = {
+	Expand8to16Key_SSE2,
+	SDL_Expand8to16_C,
+	Copy16Key_SSE41,
+	Fill16_SSE2,
+	Mix16_SSE41
+};
+
+/*
+ * AVX2
+ */
+
+/* looks up 8 palette entries at once. palmap is read 32 bits at a time,
+   which is why it needs the padding at the end. */
+static TARGET("avx2") __m128i Lookup8_AVX2(const Uint8 *src, const Uint16 *palmap)
+{
+	__m256i idx = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)src));
+	__m256i c = _mm256_i32gather_epi32((const int *)palmap, idx, 2);
+	c = _mm256_and_si256(c, _mm256_set1_epi32(0xffff));
+	/* pack within each lane, then bring the two halves together */
+	c = _mm256_permute4x64_epi64(_mm256_packus_epi32(c, c), 0x08);
+	return _mm256_castsi256_si128(c);
+}
+
+static TARGET("avx2") void Expand8to16Key_AVX2(const Uint8 *src, Uint16 *dst,
+                                              int width, const Uint16 *palmap, Uint8 key)
+{
+	const __m128i vkey = _mm_set1_epi16(key);
+
+	while ( width >= 8 ) {
+		__m128i s = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)src));
+		__m128i keyed = _mm_cmpeq_epi16(s, vkey);
+		if ( !_mm_test_all_ones(keyed) ) {
+			__m128i c = Lookup8_AVX2(src, palmap);
+			if ( !_mm_testz_si128(keyed, keyed) ) {
+				__m128i d = _mm_loadu_si128((const __m128i *)dst);
+				c = _mm_blendv_epi8(c, d, keyed);
+			}
+			_mm_storeu_si128((__m128i *)dst, c);
+		}
+		src += 8;
+		dst += 8;
+		width -= 8;
+	}
+	SDL_Expand8to16Key_C(src, dst, width, palmap, key);
+}
+
+static TARGET("avx2") void Expand8to16_AVX2(const Uint8 *src, Uint16 *dst,
+                                           int width, const Uint16 *palmap)
+{
+	while ( width >= 8 ) {
+		_mm_storeu_si128((__m128i *)dst, Lookup8_AVX2(src, palmap));
+		src += 8;
+		dst += 8;
+		width -= 8;
+	}
+	SDL_Expand8to16_C(src, dst, width, palmap);
+}
+
+static TARGET("avx2") void Copy16Key_AVX2(const Uint16 *src, Uint16 *dst,
+                                         int width, Uint16 key)
+{
+	const __m256i vkey = _mm256_set1_epi16((short)key);
+
+	while ( width >= 16 ) {
+		__m256i s = _mm256_loadu_si256((const __m256i *)src);
+		__m256i keyed = _mm256_cmpeq_epi16(s, vkey);
+		if ( _mm256_testz_si256(keyed, keyed) ) {
+			_mm256_storeu_si256((__m256i *)dst, s);
+		} else if ( !_mm256_testc_si256(keyed, _mm256_set1_epi32(-1)) ) {
+			__m256i d = _mm256_loadu_si256((const __m256i *)dst);
+			_mm256_storeu_si256((__m256i *)dst, _mm256_blendv_epi8(s, d, keyed));
+		}
+		src += 16;
+		dst += 16;
+		width -= 16;
+	}
+	Copy16Key_SSE41(src, dst, width, key);
+}
+
+static TARGET("avx2") void Fill16_AVX2(Uint16 *dst, int width, Uint16 color)
+{
+	const __m256i c = _mm256_set1_epi16((short)color);
+
+	while ( width >= 16 ) {
+		_mm256_storeu_si256((__m256i *)dst, c);
+		dst += 16;
+		width -= 16;
+	}
+	SDL_Fill16_C(dst, width, color);
+}
+
+static TARGET("avx2") void Mix16_AVX2(Sint16 *dst, const Sint16 *src,
+                                     int count, int volume)
+{
+	const __m256i vvol = _mm256_set1_epi16((short)volume);
+	const __m256i v255 = _mm256_set1_epi32(255);
+
+	while ( count >= 16 ) {
+		__m256i s = _mm256_loadu_si256((const __m256i *)src);
+		__m256i lo = _mm256_mullo_epi16(s, vvol);
+		__m256i hi = _mm256_mulhi_epi16(s, vvol);
+		/* unpack and pack both work within 128-bit lanes, so the
+		   samples come back out in the order they went in */
+		__m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+		__m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+		p0 = _mm256_srai_epi32(_mm256_add_epi32(p0, _mm256_and_si256(_mm256_srai_epi32(p0, 31), v255)), 8);
+		p1 = _mm256_srai_epi32(_mm256_add_epi32(p1, _mm256_and_si256(_mm256_srai_epi32(p1, 31), v255)), 8);
+		__m256i d = _mm256_loadu_si256((const __m256i *)dst);
+		_mm256_storeu_si256((__m256i *)dst, _mm256_adds_epi16(d, _mm256_packs_epi32(p0, p1)));
+		src += 16;
+		dst += 16;
+		count -= 16;
+	}
+	Mix16_SSE41(dst, src, count, volume);
+}
+
+static const SDL_SIMDKernels avx2_kernels = {
+	Expand8to16Key_AVX2,
+	Expand8to16_AVX2,
+	Copy16Key_AVX2,
+	Fill16_AVX2,
+	Mix16_AVX2
+};
+
+const SDL_SIMDKernels *SDL_SIMD_SSE2Kernels = &sse2_kernels;
+const SDL_SIMDKernels *SDL_SIMD_SSE41Kernels = &sse41_kernels;
+const SDL_SIMDKernels *SDL_SIMD_AVX2Kernels = &avx2_kernels;
+
+#else
+
+const SDL_SIMDKernels *SDL_SIMD_SSE2Kernels = NULL;
+const SDL_SIMDKernels *SDL_SIMD_SSE41Kernels = NULL;
+const SDL_SIMDKernels *SDL_SIMD_AVX2Kernels = NULL;
+
+#endif /* HAVE_X86_KERNELS */
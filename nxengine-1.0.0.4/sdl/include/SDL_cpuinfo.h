@@ -60,6 +60,18 @@ extern DECLSPEC SDL_bool SDLCALL SDL_HasSSE2(void);
 /** This function returns true if the CPU has AltiVec features */
 extern DECLSPEC SDL_bool SDLCALL SDL_HasAltiVec(void);
 
+/** This function returns true if the CPU has SSE4.1 features */
+extern DECLSPEC SDL_bool SDLCALL SDL_HasSSE41(void);
+
+/** This function returns true if the CPU has AVX2 features, and the OS supports them */
+extern DECLSPEC SDL_bool SDLCALL SDL_HasAVX2(void);
+
+/** This function returns true if the CPU has ARM NEON features */
+extern DECLSPEC SDL_bool SDLCALL SDL_HasNEON(void);
+
+/** This function returns true if the CPU has the PCLMULQDQ carry-less multiply instruction */
+extern DECLSPEC SDL_bool SDLCALL SDL_HasPCLMUL(void);
+
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
 }
@@ -0,0 +1,108 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+
+/**
+ *  @file SDL_simd.h
+ *  Runtime selection of vectorized pixel and sample kernels
+ */
+
+#ifndef _SDL_simd_h
+#define _SDL_simd_h
+
+#include "SDL_stdinc.h"
+
+#include "begin_code.h"
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** The instruction set paths which kernels can be built for */
+typedef enum {
+	SDL_SIMD_AUTO = -1,	/**< pick the best path this CPU supports */
+	SDL_SIMD_SCALAR = 0,	/**< plain C; the reference all others must match */
+	SDL_SIMD_SSE2,
+	SDL_SIMD_SSE41,
+	SDL_SIMD_AVX2,
+	SDL_SIMD_NEON,
+	SDL_SIMD_NUM_PATHS
+} SDL_SIMDPath;
+
+/**
+ *  The inner loops of the blitters, rect fill and audio mixer.
+ *  Each works on a single row (or run of samples), and every path
+ *  produces exactly the same output as the scalar one.
+ */
+typedef struct SDL_SIMDKernels {
+	/** dst[i] = palmap[src[i]], except where src[i] == key.
+	 *  palmap must be followed by 2 bytes of readable padding,
+	 *  as the AVX2 path fetches entries 32 bits at a time. */
+	void (*Expand8to16Key)(const Uint8 *src, Uint16 *dst, int width,
+	                       const Uint16 *palmap, Uint8 key);
+	/** dst[i] = palmap[src[i]]; same padding requirement as above */
+	void (*Expand8to16)(const Uint8 *src, Uint16 *dst, int width,
+	                    const Uint16 *palmap);
+	/** dst[i] = src[i], except where src[i] == key */
+	void (*Copy16Key)(const Uint16 *src, Uint16 *dst, int width, Uint16 key);
+	/** dst[i] = color */
+	void (*Fill16)(Uint16 *dst, int width, Uint16 color);
+	/** dst[i] = saturate(dst[i] + src[i] * volume / 256), for volume 0-256;
+	 *  the product is truncated toward zero, as by C integer division. */
+	void (*Mix16)(Sint16 *dst, const Sint16 *src, int count, int volume);
+} SDL_SIMDKernels;
+
+/** Returns the kernels for the current path, choosing one if needed.
+ *  The SDL_SIMD environment variable ("scalar", "sse2", "sse4.1", "avx2"
+ *  or "neon") overrides the automatic choice, if that path is available. */
+extern DECLSPEC const SDL_SIMDKernels * SDLCALL SDL_GetSIMDKernels(void);
+
+/** Returns the kernels for a specific path, or NULL if this
+ *  build or CPU can't run it. */
+extern DECLSPEC const SDL_SIMDKernels * SDLCALL SDL_GetSIMDKernelsFor(SDL_SIMDPath path);
+
+/** Forces the given path (or SDL_SIMD_AUTO), and returns the one actually
+ *  selected, which falls back to the best available if it's unsupported. */
+extern DECLSPEC SDL_SIMDPath SDLCALL SDL_SetSIMDPath(SDL_SIMDPath path);
+extern DECLSPEC SDL_SIMDPath SDLCALL SDL_GetSIMDPath(void);
+extern DECLSPEC const char * SDLCALL SDL_GetSIMDPathName(SDL_SIMDPath path);
+
+/** Runs every kernel of the given path against the scalar reference over
+ *  a set of test patterns, and returns the number which didn't match. */
+extern DECLSPEC int SDLCALL SDL_VerifySIMDKernels(SDL_SIMDPath path);
+
+/** Called with the name of a kernel and a description of the call
+ *  whenever a shadowed call's output doesn't match the reference. */
+typedef void (SDLCALL *SDL_SIMDShadowFunc)(const char *kernel, const char *details);
+
+/** Turns shadow checking on (with a non-NULL func) or off. While it's on,
+ *  SDL_GetSIMDKernels returns kernels which run the current path as usual,
+ *  then run the scalar reference over a copy of what the output was before
+ *  the call and compare the two. Nothing is checked on the scalar path. */
+extern DECLSPEC void SDLCALL SDL_SetSIMDShadow(SDL_SIMDShadowFunc func);
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+#include "close_code.h"
+
+#endif /* _SDL_simd_h */
@@ -25,6 +25,7 @@
 #include "SDL_blit.h"
 #include "SDL_sysvideo.h"
 #include "SDL_endian.h"
+#include "SDL_simd.h"
 
 /* Functions to blit from 8-bit surfaces to other surfaces */
 
@@ -94,15 +95,13 @@ static void Blit1to2(SDL_BlitInfo *info)
 	map = (Uint16 *)info->table;
 
 #ifdef USE_DUFFS_LOOP
-	while ( height-- ) {
-		DUFFS_LOOP(
-		{
-			*(Uint16 *)dst = map[*src++];
-			dst += 2;
-		},
-		width);
-		src += srcskip;
-		dst += dstskip;
+	{
+		const SDL_SIMDKernels *k = SDL_GetSIMDKernels();
+		while ( height-- ) {
+			k->Expand8to16(src, (Uint16 *)dst, width, map);
+			src += width + srcskip;
+			dst += width*2 + dstskip;
+		}
 	}
 #else
 	/* Memory align at 4-byte boundary, if necessary */
@@ -325,22 +324,15 @@ static void Blit1to2Key(SDL_BlitInfo *info)
 	int dstskip = info->d_skip;
 	Uint16 *palmap = (Uint16 *)info->table;
 	Uint32 ckey = info->src->colorkey;
+	const SDL_SIMDKernels *k = SDL_GetSIMDKernels();
 
 	/* Set up some basic variables */
 	dstskip /= 2;
 
 	while ( height-- ) {
-		DUFFS_LOOP(
-		{
-			if ( *src != ckey ) {
-				*dstp=palmap[*src];
-			}
-			src++;
-			dstp++;
-		},
-		width);
-		src += srcskip;
-		dstp += dstskip;
+		k->Expand8to16Key(src, dstp, width, palmap, (Uint8)ckey);
+		src += width + srcskip;
+		dstp += width + dstskip;
 	}
 }
 
@@ -24,6 +24,7 @@
 #include "SDL_video.h"
 #include "SDL_endian.h"
 #include "SDL_cpuinfo.h"
+#include "SDL_simd.h"
 #include "SDL_blit.h"
 
 /* Functions to blit from N-bit surfaces to other surfaces */
@@ -2171,6 +2172,16 @@ static void Blit2to2Key(SDL_BlitInfo *info)
         dstskip /= 2;
 	ckey &= rgbmask;
 
+	if ( rgbmask == 0xFFFFFFFF ) {
+		const SDL_SIMDKernels *k = SDL_GetSIMDKernels();
+		while ( height-- ) {
+			k->Copy16Key(srcp, dstp, width, (Uint16)ckey);
+			srcp += width + srcskip;
+			dstp += width + dstskip;
+		}
+		return;
+	}
+
 	while ( height-- ) {
 		DUFFS_LOOP(
 		{
@@ -451,7 +451,8 @@ static Uint8 *Map1toN(SDL_PixelFormat *src, SDL_PixelFormat *dst)
 	SDL_Palette *pal = src->palette;
 
 	bpp = ((dst->BytesPerPixel == 3) ? 4 : dst->BytesPerPixel);
-	map = (Uint8 *)SDL_malloc(pal->ncolors*bpp);
+	/* padded, as the SIMD palette lookups may read past the last entry */
+	map = (Uint8 *)SDL_malloc(pal->ncolors*bpp + 4);
 	if ( map == NULL ) {
 		SDL_OutOfMemory();
 		return(NULL);
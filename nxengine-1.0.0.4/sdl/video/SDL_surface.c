@@ -26,6 +26,7 @@
 #include "SDL_blit.h"
 #include "SDL_pixels_c.h"
 #include "SDL_leaks.h"
+#include "SDL_simd.h"
 
 
 /* Public routines */
@@ -608,20 +609,12 @@ int SDL_FillRect(SDL_Surface *dst, SDL_Rect *dstrect, Uint32 color)
 	} else {
 		switch (dst->format->BytesPerPixel) {
 		    case 2:
-			for ( y=dstrect->h; y; --y ) {
-				Uint16 *pixels = (Uint16 *)row;
-				Uint16 c = (Uint16)color;
-				Uint32 cc = (Uint32)c << 16 | c;
-				int n = dstrect->w;
-				if((uintptr_t)pixels & 3) {
-					*pixels++ = c;
-					n--;
+			{
+				const SDL_SIMDKernels *k = SDL_GetSIMDKernels();
+				for ( y=dstrect->h; y; --y ) {
+					k->Fill16((Uint16 *)row, dstrect->w, (Uint16)color);
+					row += dst->pitch;
 				}
-				if(n >> 1)
-					SDL_memset4(pixels, cc, n >> 1);
-				if(n & 1)
-					pixels[n - 1] = c;
-				row += dst->pitch;
 			}
 			break;
 
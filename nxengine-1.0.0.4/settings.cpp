@@ -103,6 +103,7 @@ FILE *fp;
 	retro_create_path_string(setfilename_tmp, sizeof(setfilename_tmp), g_dir, setfilename);
 	
 	NX_LOG("Writing settings...\n");
+	int64_t start = Hitch::Now();
 	fp = fopen(setfilename_tmp, "wb");
 	if (!fp)
 	{
@@ -117,6 +118,7 @@ FILE *fp;
 	fwrite(setfile, sizeof(Settings), 1, fp);
 	
 	fclose(fp);
+	Hitch::Event(HE_SETTINGS_SAVE, start);
 	return 0;
 }
 
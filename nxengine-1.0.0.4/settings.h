@@ -24,7 +24,10 @@ struct Settings
 	bool inhibit_fullscreen;
 	
 	bool skip_intro;
-	int reserved[8];
+	int detail_budget;		// usec per frame before cosmetic detail is thinned; 0=off
+	int hitch_budget;		// usec per frame before the hitch recorder dumps; 0=default, -1=off
+	int stage_bundles;		// per-stage asset bundles; 1=on, 0 or -1=off
+	int reserved[5];
 	
 	int input_mappings[INPUT_COUNT];
 };
@@ -0,0 +1,122 @@
+
+// shadow checking; see shadow.h.
+
+#include "nx.h"
+#include <stdarg.h>
+#include "libretro/libretro_shared.h"
+#include <SDL_simd.h>
+#include "shadow.fdh"
+
+bool shadow_enabled = false;
+
+static struct
+{
+	// the kernels which have mismatched so far, and how many times each has
+	const char *kernels[SHADOW_MAX_KERNELS];
+	int mismatches[SHADOW_MAX_KERNELS];
+	int nkernels;
+	int total;
+	
+	FILE *fp;
+} sh;
+
+
+// turns shadowing on at startup if the NX_SHADOW environment variable is set
+void Shadow::Init(void)
+{
+	const char *env = getenv("NX_SHADOW");
+	
+	if (env && atoi(env))
+		SetEnabled(true);
+}
+
+void Shadow::SetEnabled(bool enable)
+{
+	if (enable == shadow_enabled)
+		return;
+	
+	if (enable)
+	{
+		memset(&sh, 0, sizeof(sh));
+		NX_LOG("Shadow: checking kernels against their references\n");
+	}
+	else
+	{
+		NX_LOG("Shadow: stopped, after %d mismatches\n", sh.total);
+		
+		if (sh.fp)
+		{
+			fclose(sh.fp);
+			sh.fp = NULL;
+		}
+	}
+	
+	shadow_enabled = enable;
+	SDL_SetSIMDShadow(enable ? simd_mismatch : NULL);
+}
+
+// returns the number of calls which haven't matched since shadowing was turned on
+int Shadow::Mismatches(void)
+{
+	return sh.total;
+}
+
+/*
+void c------------------------------() {}
+*/
+
+// called by a kernel when it's output doesn't match it's reference.
+// only the first mismatch of each kernel is reported; the rest are just counted,
+// as a kernel that's wrong once is usually wrong on every frame after.
+void Shadow::Mismatch(const char *kernel, const char *fmt, ...)
+{
+va_list ar;
+char details[256];
+int i;
+
+	sh.total++;
+	
+	for(i=0;i<sh.nkernels;i++)
+	{
+		if (!strcmp(sh.kernels[i], kernel))
+		{
+			sh.mismatches[i]++;
+			return;
+		}
+	}
+	
+	if (sh.nkernels >= SHADOW_MAX_KERNELS)
+		return;
+	
+	sh.kernels[sh.nkernels] = kernel;
+	sh.mismatches[sh.nkernels] = 1;
+	sh.nkernels++;
+	
+	va_start(ar, fmt);
+	vsnprintf(details, sizeof(details), fmt, ar);
+	va_end(ar);
+	
+	NX_ERR("Shadow: %s doesn't match the reference: %s\n", kernel, details);
+	visible_warning("shadow: %s mismatch", kernel);
+	
+	if (!sh.fp)
+	{
+		char path[MAXPATHLEN];
+		retro_create_path_string(path, sizeof(path), g_dir, SHADOW_FNAME);
+		
+		sh.fp = fopen(path, "wb");
+		if (!sh.fp)
+		{
+			NX_ERR("Shadow: couldn't open '%s'\n", path);
+			return;
+		}
+	}
+	
+	fprintf(sh.fp, "%s, in map %d mode %d: %s\n", kernel, game.curmap, game.mode, details);
+	fflush(sh.fp);
+}
+
+static void simd_mismatch(const char *kernel, const char *details)
+{
+	Shadow::Mismatch(kernel, "%s", details);
+}
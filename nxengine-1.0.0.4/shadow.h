@@ -0,0 +1,34 @@
+
+#ifndef _SHADOW_H
+#define _SHADOW_H
+
+// shadow checking, for trying out faster versions of the engine's inner loops.
+// a kernel which has a reference version of itself (the scalar blit and mix
+// kernels, the byte-at-a-time crc, the object boxes worked out fresh from the
+// sprite) runs the reference alongside itself whenever shadowing is on, over a
+// copy of it's inputs, and compares the two right there. the first call of each
+// kernel which doesn't match is written to shadow.txt along with it's arguments,
+// so a fast path can be tried out in ordinary play, and the call that goes wrong
+// found as it happens rather than as a replay diverging hundreds of frames later.
+//
+// it's off by default and costs a kernel one check of shadow_enabled when it is.
+// turn it on from the console with "shadow on", or by setting NX_SHADOW=1.
+
+#define SHADOW_MAX_KERNELS		16			// how many different kernels can be reported
+#define SHADOW_FNAME			"shadow.txt"
+
+// checked by the kernels before running their reference
+extern bool shadow_enabled;
+
+namespace Shadow
+{
+	void Init(void);
+	
+	void SetEnabled(bool enable);
+	int Mismatches(void);
+	
+	// kernel must be a string constant
+	void Mismatch(const char *kernel, const char *fmt, ...);
+};
+
+#endif
@@ -0,0 +1,374 @@
+
+// soak mode; see soak.h.
+
+#include "nx.h"
+#include "maprecord.h"
+#include "pause/options.h"
+#include "libretro/libretro_shared.h"
+
+#ifdef __linux__
+	#include <dirent.h>
+	#include <unistd.h>
+#endif
+#ifdef __GLIBC__
+	#include <malloc.h>
+#endif
+
+#include "soak.fdh"
+
+#define SOAK_FILENAME		"soak.csv"
+#define SOAK_START_STAGE	1			// stage 0 is the null stage
+#define SOAK_REPLAY_TIMEOUT	500			// frames to wait for a replay to begin
+
+static const char *metric_names[] =
+{
+	"rss_kb", "heap_bytes", "open_files",
+	"objects", "carets", "floattexts", "orphan_floattexts",
+	"spritesheets", "backdrops", "script_bytes", "focus_holders",
+	"frame_usec"
+};
+
+static struct
+{
+	int mode;
+	int param;				// frames per stage, or replay slot
+	
+	int loop;				// how many loops have been completed
+	int stage;				// stage being visited, in SOAK_WARP
+	int timer;				// frames spent in the current stage or replay
+	bool started;			// the replay has begun playing, in SOAK_REPLAY
+	bool old_god;
+	
+	int64_t frame_start;
+	int64_t loop_usec;		// total tick time so far this loop
+	int loop_frames;
+	
+	// the most recent samples (not counting the first loop, which is
+	// still warming up), oldest first.
+	int history[SOAK_GROWTH_SAMPLES][SM_NUM_METRICS];
+	int nhistory;
+	bool growing[SM_NUM_METRICS];
+	
+	FILE *fp;
+} soak;
+
+extern Options::FocusStack optionstack;
+
+
+bool Soak::Start(int mode, int param)
+{
+char fname[MAXPATHLEN];
+
+	if (IsRunning())
+		Stop();
+	
+	if (mode == SOAK_REPLAY)
+	{
+		ReplaySlotInfo slot;
+		Replay::GetSlotInfo(param, &slot);
+		
+		if (slot.status == RS_UNUSED)
+		{
+			NX_ERR("Soak::Start: there is no replay in slot %d\n", param);
+			return 1;
+		}
+	}
+	else if (param <= SOAK_SAMPLE_SETTLE)
+	{
+		param = SOAK_DEFAULT_STAGE_FRAMES;
+	}
+	
+	retro_create_path_string(fname, sizeof(fname), g_dir, SOAK_FILENAME);
+	FILE *fp = fopen(fname, "wb");
+	if (!fp)
+	{
+		NX_ERR("Soak::Start: couldn't open '%s'\n", fname);
+		return 1;
+	}
+	
+	memset(&soak, 0, sizeof(soak));
+	soak.mode = mode;
+	soak.param = param;
+	soak.fp = fp;
+	
+	fprintf(fp, "loop,frames");
+	for(int i=0;i<SM_NUM_METRICS;i++)
+		fprintf(fp, ",%s", metric_names[i]);
+	fprintf(fp, ",growing\n");
+	fflush(fp);
+	
+	if (mode == SOAK_WARP)
+	{
+		// we're not here to test if the player can survive the stage
+		soak.old_god = game.debug.god;
+		game.debug.god = true;
+		
+		soak.stage = SOAK_START_STAGE;
+		start_stage();
+		
+		NX_LOG("Soak: warping through all stages, %d frames each\n", param);
+	}
+	else
+	{
+		start_replay();
+		NX_LOG("Soak: looping replay slot %d\n", param);
+	}
+	
+	return 0;
+}
+
+void Soak::Stop(void)
+{
+	if (!IsRunning())
+		return;
+	
+	NX_LOG("Soak: stopped after %d loops\n", soak.loop);
+	
+	if (soak.mode == SOAK_WARP)
+		game.debug.god = soak.old_god;
+	
+	fclose(soak.fp);
+	memset(&soak, 0, sizeof(soak));
+}
+
+bool Soak::IsRunning(void)
+{
+	return (soak.mode != SOAK_OFF);
+}
+
+/*
+void c------------------------------() {}
+*/
+
+void Soak::BeginFrame(void)
+{
+	if (soak.mode != SOAK_OFF)
+		soak.frame_start = retro_get_usec();
+}
+
+void Soak::EndFrame(void)
+{
+	if (soak.mode == SOAK_OFF)
+		return;
+	
+	soak.loop_usec += (retro_get_usec() - soak.frame_start);
+	soak.loop_frames++;
+	soak.timer++;
+	
+	if (soak.mode == SOAK_WARP)
+	{
+		// sample at the same point in every pass, once the first stage
+		// has had a moment to get going.
+		if (soak.stage == SOAK_START_STAGE && soak.timer == SOAK_SAMPLE_SETTLE)
+			end_loop();
+		
+		if (soak.timer >= soak.param)
+		{
+			// the stage table is bigger than the number of stages in the game
+			if (++soak.stage >= num_stages || !stages[soak.stage].filename[0])
+				soak.stage = SOAK_START_STAGE;
+			
+			start_stage();
+		}
+	}
+	else
+	{
+		if (Replay::IsPlaying())
+		{
+			soak.started = true;
+		}
+		else if (soak.started)
+		{
+			end_loop();
+			start_replay();
+		}
+		else if (soak.timer >= SOAK_REPLAY_TIMEOUT)
+		{
+			NX_ERR("Soak: replay slot %d didn't start playing\n", soak.param);
+			Stop();
+		}
+	}
+}
+
+static void start_stage(void)
+{
+	StopScripts();
+	
+	game.switchstage.mapno = soak.stage;
+	game.switchstage.playerx = 16;
+	game.switchstage.playery = 16;
+	game.switchstage.eventonentry = 0;
+	
+	soak.timer = 0;
+}
+
+static void start_replay(void)
+{
+	game.switchstage.mapno = START_REPLAY;
+	game.switchstage.param = soak.param;
+	
+	soak.timer = 0;
+	soak.started = false;
+}
+
+/*
+void c------------------------------() {}
+*/
+
+// takes this loop's sample, writes it out and checks it for growth
+static void end_loop(void)
+{
+int values[SM_NUM_METRICS];
+int i;
+
+	Soak::Sample(values);
+	
+	values[SM_FRAME_USEC] = soak.loop_frames ? (int)(soak.loop_usec / soak.loop_frames) : 0;
+	
+	// the first pass is when everything gets loaded for the first time,
+	// so it's recorded, but not held against the later ones.
+	if (soak.loop > 0)
+	{
+		if (soak.nhistory == SOAK_GROWTH_SAMPLES)
+		{
+			memmove(soak.history[0], soak.history[1], sizeof(soak.history[0]) * (SOAK_GROWTH_SAMPLES - 1));
+			soak.nhistory--;
+		}
+		
+		memcpy(soak.history[soak.nhistory++], values, sizeof(values));
+		check_growth();
+	}
+	
+	fprintf(soak.fp, "%d,%d", soak.loop, soak.loop_frames);
+	for(i=0;i<SM_NUM_METRICS;i++)
+		fprintf(soak.fp, ",%d", values[i]);
+	
+	fprintf(soak.fp, ",");
+	for(i=0;i<SM_NUM_METRICS;i++)
+	{
+		if (soak.growing[i])
+			fprintf(soak.fp, "%s ", metric_names[i]);
+	}
+	
+	fprintf(soak.fp, "\n");
+	fflush(soak.fp);
+	
+	soak.loop++;
+	soak.loop_usec = 0;
+	soak.loop_frames = 0;
+}
+
+// a metric is considered to be growing if it never went down over the
+// whole history, and ended up higher than it started.
+static void check_growth(void)
+{
+	if (soak.nhistory < SOAK_GROWTH_SAMPLES)
+		return;
+	
+	for(int m=0;m<SM_NUM_METRICS;m++)
+	{
+		int first = soak.history[0][m];
+		int last = soak.history[SOAK_GROWTH_SAMPLES - 1][m];
+		bool growing = (first >= 0 && last > first);
+		
+		for(int i=1;i<SOAK_GROWTH_SAMPLES && growing;i++)
+		{
+			if (soak.history[i][m] < soak.history[i - 1][m])
+				growing = false;
+		}
+		
+		if (growing && !soak.growing[m])
+		{
+			NX_ERR("Soak: %s has grown for %d loops in a row (%d -> %d)\n", \
+					metric_names[m], SOAK_GROWTH_SAMPLES, first, last);
+		}
+		
+		soak.growing[m] = growing;
+	}
+}
+
+/*
+void c------------------------------() {}
+*/
+
+// fills values with the current reading of every metric.
+// anything which can't be measured on this platform is set to -1.
+void Soak::Sample(int *values)
+{
+Object *o;
+int count;
+
+	values[SM_RSS_KB] = get_rss_kb();
+	values[SM_HEAP_BYTES] = get_heap_bytes();
+	values[SM_OPEN_FILES] = get_open_files();
+	
+	count = 0;
+	FOREACH_OBJECT(o) count++;
+	values[SM_OBJECTS] = count;
+	
+	values[SM_CARETS] = Carets::CountAll();
+	values[SM_FLOATTEXTS] = FloatText::CountAll(&values[SM_ORPHAN_FLOATTEXTS]);
+	values[SM_SPRITESHEETS] = Sprites::CountLoadedSheets();
+	values[SM_BACKDROPS] = map_count_backdrops();
+	values[SM_SCRIPT_BYTES] = tsc_script_bytes();
+	values[SM_FOCUS_HOLDERS] = optionstack.CountItems();
+	values[SM_FRAME_USEC] = -1;
+}
+
+const char *Soak::MetricName(int metric)
+{
+	if (metric < 0 || metric >= SM_NUM_METRICS)
+		return "invalid";
+	
+	return metric_names[metric];
+}
+
+static int get_rss_kb(void)
+{
+#ifdef __linux__
+	FILE *fp = fopen("/proc/self/statm", "rb");
+	if (!fp) return -1;
+	
+	long pages, resident;
+	int n = fscanf(fp, "%ld %ld", &pages, &resident);
+	fclose(fp);
+	
+	if (n == 2)
+		return (int)((resident * sysconf(_SC_PAGESIZE)) / 1024);
+#endif
+	return -1;
+}
+
+static int get_heap_bytes(void)
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+	struct mallinfo2 mi = mallinfo2();
+	return (int)(mi.uordblks + mi.hblkhd);
+#elif defined(__GLIBC__)
+	struct mallinfo mi = mallinfo();
+	return (mi.uordblks + mi.hblkhd);
+#else
+	return -1;
+#endif
+}
+
+static int get_open_files(void)
+{
+#ifdef __linux__
+	DIR *dir = opendir("/proc/self/fd");
+	if (!dir) return -1;
+	
+	int count = 0;
+	while(struct dirent *ent = readdir(dir))
+	{
+		if (ent->d_name[0] != '.')
+			count++;
+	}
+	
+	closedir(dir);
+	return (count - 1);		// don't count the one we're reading it through
+#else
+	return -1;
+#endif
+}
+
@@ -0,0 +1,58 @@
+
+#ifndef _SOAK_H
+#define _SOAK_H
+
+// soak mode runs the game unattended for hours at a time, either warping
+// through every stage in turn or looping a replay, to catch slow leaks and
+// performance decay which never show up in a normal session.
+//
+// once per loop (a full pass over the stages, or one play of the replay) it
+// samples process memory and the engine's own live counts, at the same point
+// in the loop each time so the readings are comparable, and writes them to
+// soak.csv. any reading which has grown at every one of the last few samples
+// is reported as a probable leak.
+
+enum SoakModes
+{
+	SOAK_OFF = 0,
+	SOAK_WARP,				// warp through all stages, N frames in each
+	SOAK_REPLAY				// play a replay slot over and over
+};
+
+#define SOAK_DEFAULT_STAGE_FRAMES	300		// 6 seconds in each stage
+#define SOAK_SAMPLE_SETTLE			100		// frames after entering a stage before sampling
+#define SOAK_GROWTH_SAMPLES			6		// how many growing samples in a row is a leak
+
+// the things soak mode tracks
+enum SoakMetrics
+{
+	SM_RSS_KB,				// resident set size of the process
+	SM_HEAP_BYTES,			// bytes allocated from the heap
+	SM_OPEN_FILES,			// open file descriptors
+	SM_OBJECTS,				// live objects
+	SM_CARETS,				// live carets
+	SM_FLOATTEXTS,			// live floattexts
+	SM_ORPHAN_FLOATTEXTS,	// floattexts left behind by a destroyed object
+	SM_SPRITESHEETS,		// loaded sprite sheets
+	SM_BACKDROPS,			// loaded backdrops
+	SM_SCRIPT_BYTES,		// compiled TSC held in all script pages
+	SM_FOCUS_HOLDERS,		// dialogs & messages on the options stack
+	SM_FRAME_USEC,			// average tick time over the loop
+	
+	SM_NUM_METRICS
+};
+
+namespace Soak
+{
+	bool Start(int mode, int param);
+	void Stop(void);
+	bool IsRunning(void);
+	
+	void BeginFrame(void);
+	void EndFrame(void);
+	
+	void Sample(int *values);
+	const char *MetricName(int metric);
+};
+
+#endif
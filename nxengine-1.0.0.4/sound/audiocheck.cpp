@@ -0,0 +1,324 @@
+
+// audio output check for replay playback; see audiocheck.h.
+
+#include "../nx.h"
+#include "audiocheck.h"
+#include "../common/checksum.h"
+#include "libretro_shared.h"
+#include "audiocheck.fdh"
+
+static struct
+{
+	int mode;
+	int tolerance;			// max envelope error accepted when the hashes differ
+	
+	bool active;
+	bool recording;
+	FILE *fp;
+	char fname[MAXPATHLEN];
+	
+	ACBlock cur;			// block being built by the current mixaudio() call
+	int nblocks;
+	
+	// verify results
+	bool ref_ended;
+	int ndiverged;
+	int first_diverged;
+	int napprox;
+	int max_error;
+} ac;
+
+
+void audiocheck_set_mode(int mode, int tolerance)
+{
+	ac.mode = mode;
+	ac.tolerance = (tolerance > 0) ? tolerance : 0;
+}
+
+int audiocheck_get_mode(void)
+{
+	return ac.mode;
+}
+
+bool audiocheck_active(void)
+{
+	return ac.active;
+}
+
+/*
+void c------------------------------() {}
+*/
+
+// called as a replay is about to begin playback. opens or creates
+// the reference file belonging to that replay.
+bool audiocheck_begin(const char *replay_fname)
+{
+	audiocheck_end();
+	if (ac.mode == AC_OFF)
+		return 0;
+	
+	get_reference_name(replay_fname, ac.fname);
+	ac.recording = true;
+	ac.fp = NULL;
+	
+	if (ac.mode == AC_AUTO)
+	{
+		FILE *fp = fopen(ac.fname, "rb");
+		if (fp)
+		{
+			if (fgetl(fp) == AC_MAGICK && fgetl(fp) == AC_VERSION)
+			{
+				ac.fp = fp;
+				ac.recording = false;
+			}
+			else
+			{
+				NX_ERR("audiocheck: '%s' is not a valid reference; re-recording it\n", ac.fname);
+				fclose(fp);
+			}
+		}
+	}
+	
+	if (ac.recording)
+	{
+		ac.fp = fopen(ac.fname, "wb");
+		if (!ac.fp)
+		{
+			NX_ERR("audiocheck: couldn't create '%s'\n", ac.fname);
+			return 1;
+		}
+		
+		fputl(AC_MAGICK, ac.fp);
+		fputl(AC_VERSION, ac.fp);
+	}
+	
+	// what comes out must depend only on the replay, so silence anything left
+	// over from before it, and make sure the music gets restarted from the top.
+	// the frame lengths alternate, so line those up too.
+	music(0);
+	for(int c=0;c<SS_NUM_CHANNELS;c++)
+		SSAbortChannel(c);
+	
+	retro_sync_audio_phase();
+	
+	memset(&ac.cur, 0, sizeof(ac.cur));
+	ac.nblocks = 0;
+	ac.ref_ended = false;
+	ac.ndiverged = 0;
+	ac.first_diverged = -1;
+	ac.napprox = 0;
+	ac.max_error = 0;
+	ac.active = true;
+	
+	NX_LOG("audiocheck: %s '%s'\n", ac.recording ? "recording" : "verifying against", ac.fname);
+	return 0;
+}
+
+// called when playback ends; closes the reference and reports the result.
+void audiocheck_end(void)
+{
+	if (!ac.active)
+		return;
+	
+	ac.active = false;
+	
+	if (ac.recording)
+	{
+		NX_LOG("audiocheck: recorded %d blocks to '%s'\n", ac.nblocks, ac.fname);
+		visible_warning("audio check: recorded %d blocks", ac.nblocks);
+	}
+	else
+	{
+		ACBlock ref;
+		if (!ac.ref_ended && fread(&ref, sizeof(ref), 1, ac.fp) == 1)
+		{
+			NX_ERR("audiocheck: playback ended at block %d, before the reference did\n", ac.nblocks);
+			if (ac.first_diverged == -1)
+				ac.first_diverged = ac.nblocks;
+		}
+		
+		if (ac.first_diverged == -1)
+		{
+			NX_LOG("audiocheck: all %d blocks match (%d within tolerance, max error %d)\n", \
+					ac.nblocks, ac.napprox, ac.max_error);
+			visible_warning("audio check: %d blocks OK", ac.nblocks);
+		}
+		else
+		{
+			NX_ERR("audiocheck: FAILED; first divergence at block %d, %d of %d blocks differ\n", \
+					ac.first_diverged, ac.ndiverged, ac.nblocks);
+			visible_warning("audio check: FAILED at block %d", ac.first_diverged);
+		}
+	}
+	
+	fclose(ac.fp);
+	ac.fp = NULL;
+}
+
+/*
+void c------------------------------() {}
+*/
+
+// called by the mixer with what channel c is about to add to the mix
+void audiocheck_channel(int c, const int16_t *samples, int len_samples, int volume)
+{
+	if (!ac.active)
+		return;
+	
+	uint32_t hash = crc_calc(&volume, sizeof(volume));
+	
+	ac.cur.chanmask |= (1 << c);
+	ac.cur.chanhash[c] = crc_update(hash, samples, len_samples * sizeof(int16_t));
+}
+
+// called by the mixer once the block is completely mixed
+void audiocheck_block(const int16_t *stream, int len_samples)
+{
+	if (!ac.active)
+		return;
+	
+	ACBlock *blk = &ac.cur;
+	int nframes = (len_samples / 2);
+	
+	blk->nsamples = len_samples;
+	
+	for(int side=0;side<2;side++)
+	{
+		uint32_t hash = FNV_BASIS;
+		int sum = 0, count = 0, pt = 0;
+		
+		for(int i=0;i<nframes;i++)
+		{
+			int16_t sample = stream[(i * 2) + side];
+			hash = fnv_hash(hash, &sample, sizeof(sample));
+			
+			sum += sample;
+			if (++count == (1 << AC_ENV_SHIFT) || i == nframes - 1)
+			{
+				if (pt < AC_ENV_POINTS)
+					blk->env[side][pt++] = (sum / count);
+				
+				sum = count = 0;
+			}
+		}
+		
+		blk->outhash[side] = hash;
+	}
+	
+	if (ac.recording)
+		fwrite(blk, sizeof(ACBlock), 1, ac.fp);
+	else
+		verify_block(blk);
+	
+	memset(blk, 0, sizeof(ACBlock));
+	ac.nblocks++;
+}
+
+/*
+void c------------------------------() {}
+*/
+
+static void verify_block(ACBlock *blk)
+{
+ACBlock ref;
+int side, c;
+
+	if (ac.ref_ended)
+		return;
+	
+	if (fread(&ref, sizeof(ref), 1, ac.fp) != 1)
+	{
+		NX_ERR("audiocheck: the reference ends at block %d, before playback did\n", ac.nblocks);
+		ac.ref_ended = true;
+		diverged();
+		return;
+	}
+	
+	if (ref.nsamples != blk->nsamples)
+	{
+		if (ac.first_diverged == -1)
+		{
+			NX_ERR("audiocheck: block %d is %d samples long, but %d in the reference\n", \
+					ac.nblocks, blk->nsamples, ref.nsamples);
+		}
+		
+		diverged();
+		return;
+	}
+	
+	if (ref.outhash[0] == blk->outhash[0] && ref.outhash[1] == blk->outhash[1])
+		return;
+	
+	// the exact output differs, but it might be close enough
+	int error = 0;
+	for(side=0;side<2;side++)
+	for(int i=0;i<AC_ENV_POINTS;i++)
+	{
+		int diff = abs(ref.env[side][i] - blk->env[side][i]);
+		if (diff > error) error = diff;
+	}
+	
+	if (ac.tolerance && error <= ac.tolerance)
+	{
+		ac.napprox++;
+		if (error > ac.max_error) ac.max_error = error;
+		return;
+	}
+	
+	if (ac.first_diverged == -1)
+	{
+		// find what went wrong; the first mixer channel whose input changed
+		// is the most likely culprit, if it wasn't the mixing itself.
+		for(side=0;side<2;side++)
+		{
+			if (ref.outhash[side] != blk->outhash[side])
+				break;
+		}
+		
+		for(c=0;c<SS_NUM_CHANNELS;c++)
+		{
+			if (((ref.chanmask ^ blk->chanmask) & (1 << c)) || \
+				ref.chanhash[c] != blk->chanhash[c])
+				break;
+		}
+		
+		if (c < SS_NUM_CHANNELS)
+		{
+			NX_ERR("audiocheck: block %d diverges on the %s output; SSChannel %d differs " \
+					"(%s in the reference), max error %d\n", ac.nblocks, side ? "right" : "left", c, \
+					(ref.chanmask & (1 << c)) ? "playing" : "silent", error);
+		}
+		else
+		{
+			NX_ERR("audiocheck: block %d diverges on the %s output; all channel inputs " \
+					"match, so the mixing differs. max error %d\n", ac.nblocks, side ? "right" : "left", error);
+		}
+	}
+	
+	diverged();
+}
+
+static void diverged(void)
+{
+	if (ac.first_diverged == -1)
+		ac.first_diverged = ac.nblocks;
+	
+	ac.ndiverged++;
+}
+
+/*
+void c------------------------------() {}
+*/
+
+// the reference for "replay/rep0.dat" is "replay/rep0.aud"
+static void get_reference_name(const char *replay_fname, char *buffer)
+{
+	maxcpy(buffer, replay_fname, MAXPATHLEN - 8);
+	
+	char *ext = strrchr(buffer, '.');
+	if (ext && !strchr(ext, '/') && !strchr(ext, '\\'))
+		*ext = 0;
+	
+	strcat(buffer, AC_EXTENSION);
+}
+
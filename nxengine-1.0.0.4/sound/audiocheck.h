@@ -0,0 +1,52 @@
+
+#ifndef _AUDIOCHECK_H
+#define _AUDIOCHECK_H
+
+#include <stdint.h>
+#include "sslib.h"
+
+// the audio check hashes everything the mixer outputs while a replay plays back,
+// block by block (a block being one mixaudio() call, i.e. one frame), and compares
+// it against a reference recorded from an earlier playback of the same replay.
+// it's for making sure changes to the mixer, org synth etc don't change what
+// comes out of the speakers, without having to listen for it.
+//
+// each block also keeps a coarse envelope of the output, so that paths which are
+// meant to be approximate can be checked against a maximum error instead.
+
+#define AC_MAGICK			'NXAH'
+#define AC_VERSION			2
+#define AC_EXTENSION		".aud"
+
+#define AC_ENV_SHIFT		4			// each envelope point averages 16 samples
+#define AC_ENV_POINTS		24			// enough for one frame at 22050hz
+
+enum AudioCheckModes
+{
+	AC_OFF,
+	AC_AUTO,			// verify against the reference if there is one, else record it
+	AC_RECORD			// always (re-)record the reference
+};
+
+struct ACBlock
+{
+	uint16_t nsamples;					// length of the block (left + right)
+	uint16_t chanmask;					// which SSChannels were mixed into it
+	
+	uint32_t chanhash[SS_NUM_CHANNELS];	// what each channel contributed, before volume
+	uint32_t outhash[2];				// left & right of the final mix
+	
+	int16_t env[2][AC_ENV_POINTS];		// averaged left & right output
+};
+
+void audiocheck_set_mode(int mode, int tolerance);
+int audiocheck_get_mode(void);
+
+bool audiocheck_begin(const char *replay_fname);
+void audiocheck_end(void);
+bool audiocheck_active(void);
+
+void audiocheck_channel(int c, const int16_t *samples, int len_samples, int volume);
+void audiocheck_block(const int16_t *stream, int len_samples);
+
+#endif
@@ -10,6 +10,7 @@
 #include "org.h"
 #include "pxt.h"			// for loading drums
 #include "sslib.h"			// SAMPLE_RATE
+#include "../bootcache.h"
 #include "org.fdh"
 
 #include "libretro_shared.h"
@@ -54,6 +55,7 @@ static struct
 {
 	signed short *samples;
 	int nsamples;
+	bool shared;		// samples point into the boot cache and aren't ours to free
 } drumtable[NUM_DRUMS];
 
 static int pitch[NUM_NOTES];
@@ -90,16 +92,63 @@ static int SamplesToMS(int samples)
 }
 
 
-static bool load_drumtable(FILE *fp)		// pxt_path = the path where drum pxt files can be found
+static bool load_drumtable(FILE *fp)		// fp = the exe the drum pxt's can be extracted from
 {
+   uint8_t *cache;
+   int cache_len;
+
+   // try and load the drums from the boot cache instead of synthing them
+   cache = bootcache_find(BC_DRUMS, &cache_len);
+   if (cache)
+   {
+      if (load_drumtable_cache(cache, cache_len) == 0)
+      {
+         NX_LOG("-- Drums loaded from cache\n");
+         return 0;
+      }
+
+      // throw away anything it got partway through restoring
+      memset(drumtable, 0, sizeof(drumtable));
+   }
+
    NX_LOG("load_drumtable: cache gone; rebuilding drums...\n");
 
    pxt_initsynth();
 
+   DBuffer cachebuf;
    for (int d = 0; d < NUM_DRUMS; d++)
    {
       if (drum_pxt[d])
          if (load_drum_pxt(fp, drum_pxt[d], d)) return 1;
+
+      // cache the drums for next time
+      cachebuf.Append32(drumtable[d].nsamples);
+      cachebuf.AppendData((uint8_t *)drumtable[d].samples, drumtable[d].nsamples * 2);
+   }
+
+   bootcache_add(BC_DRUMS, &cachebuf);
+   return 0;
+}
+
+static bool load_drumtable_cache(uint8_t *data, int length)
+{
+   uint8_t *end = data + length;
+
+   for (int d = 0; d < NUM_DRUMS; d++)
+   {
+      uint32_t nsamples;
+      if (data + 4 > end) return 1;
+      memcpy(&nsamples, data, 4);
+      data += 4;
+
+      if (nsamples * 2 > (uint32_t)(end - data)) return 1;
+
+      // use the samples in-place; the cache stays loaded as long as we're running
+      drumtable[d].nsamples = nsamples;
+      drumtable[d].samples = nsamples ? (signed short *)data : NULL;
+      drumtable[d].shared = true;
+
+      data += nsamples * 2;
    }
 
    return 0;
@@ -186,7 +235,7 @@ int d;
 	free_buffers();
 	
 	for(d=0;d<NUM_DRUMS;d++)
-		if (drumtable[d].samples) free(drumtable[d].samples);
+		if (drumtable[d].samples && !drumtable[d].shared) free(drumtable[d].samples);
 }
 
 int mgetc(char **fp)
@@ -777,7 +826,9 @@ void org_run(void)
 	// generate more music for it and queue it back on.
 	if (!buffers_full)
 	{
+		int64_t start = Hitch::Now();
 		generate_music();				// generate more music into current_buffer
+		Hitch::Event(HE_MUSIC_GEN, start);
 		
 		queue_final_buffer();			// enqueue current_buffer and switch buffers
 		buffers_full = true;			// both buffers full again until OrgBufferFinished called
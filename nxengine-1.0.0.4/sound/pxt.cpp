@@ -11,6 +11,7 @@
 #include "../config.h"
 #include "pxt.h"
 #include "sslib.h"
+#include "../bootcache.h"
 
 #include "pxt.fdh"
 #include "../libretro/libretro_shared.h"
@@ -46,7 +47,8 @@ static struct
 {
 	int16_t *buffer;
 	int len;
-	int loops_left;
+	bool shared;		// buffer points into the boot cache and isn't ours to free
+	uint32_t rate;		// the speed it's played at; see pxt_SetRate
 	void (*DoneCallback)(int, int);
 	int channel;
 } sound_fx[256];
@@ -188,7 +190,11 @@ int i;
 	else inited = 1;
 	
 	memset(sound_fx, 0, sizeof(sound_fx));
-	for(i=0;i<256;i++) sound_fx[i].channel = -1;
+	for(i=0;i<256;i++)
+	{
+		sound_fx[i].channel = -1;
+		sound_fx[i].rate = SS_RATE_NORMAL;
+	}
 	
 	return 0;
 }
@@ -593,28 +599,24 @@ int malc_size;
 	
 	sound_fx[slot].buffer = outbuffer;
 	sound_fx[slot].len = snd->final_size;
+	sound_fx[slot].shared = false;
 	//lprintf("pxt ready to play in slot %d\n", slot);
 }
 
-// quick-and-dirty function to raise or lower the pitch of a sound.
-// I say quick-and-dirty because it also changes the length.
-// We need this for the "SSS" (Stream Sound) which is supposed to
-// have adjustable pitch.
-void pxt_ChangePitch(stPXSound *snd, double factor)
+// sets the speed the sound in the given slot plays at, which raises or lowers
+// it's pitch (and changes it's length). this is for the "SSS" (Stream Sound),
+// which is supposed to have adjustable pitch. it's done by the mixer as the
+// sound plays, so it doesn't need re-rendering, and if it's already playing
+// the change is heard straight away.
+void pxt_SetRate(int slot, uint32_t rate)
 {
-signed char *inbuffer = snd->final_buffer;
-int insize = snd->final_size;
-
-	int outsize = (int)((double)insize * factor);
-	signed char *outbuffer = (signed char *)malloc(outsize);
-	if (factor == 0) factor = 0.001;
-	
-	for(int i=0;i<outsize;i++)
-		outbuffer[i] = inbuffer[(int)((double)i / factor)];
+	sound_fx[slot].rate = rate;
 	
-	free(snd->final_buffer);
-	snd->final_buffer = outbuffer;
-	snd->final_size = outsize;
+	SSLockAudio();
+	int chan = sound_fx[slot].channel;
+	if (chan != -1 && SSChannelPlaying(chan) && SSGetCurUserData(chan) == slot)
+		SSSetRate(chan, rate);
+	SSUnlockAudio();
 }
 
 
@@ -632,18 +634,13 @@ int pxt_PlayWithCallback(int chan, int slot, char loop, void (*FinishedCB)(int,
 	{
 		// locking the audio here ensures that sound won't finish before we get down
 		// below and finish setting it's params.
+		// looping sounds are looped by the mixer itself, so they
+		// just go back round to the start until they're stopped.
 		SSLockAudio();
-		if (loop)
-		{
-			chan = SSPlayChunk(chan, sound_fx[slot].buffer, sound_fx[slot].len, slot, pxtLooper);
-			SSEnqueueChunk(chan, sound_fx[slot].buffer, sound_fx[slot].len, slot, pxtLooper);
-			
-			sound_fx[slot].loops_left = (loop==-1) ? -1 : (loop - 1);
-		}
-		else
-		{
-			chan = SSPlayChunk(chan, sound_fx[slot].buffer, sound_fx[slot].len, slot, pxtSoundDone);
-		}
+		int loops = (loop == -1) ? SS_LOOP_FOREVER : MAX(loop - 1, 0);
+		
+		chan = SSPlayVoice(chan, sound_fx[slot].buffer, sound_fx[slot].len, \
+						0, loops, sound_fx[slot].rate, slot, pxtSoundDone);
 		
 		sound_fx[slot].DoneCallback = FinishedCB;
 		sound_fx[slot].channel = chan;
@@ -671,27 +668,12 @@ static void pxtSoundDone(int chan, int slot)
 	}
 }
 
-static void pxtLooper(int chan, int slot)
-{
-	if (sound_fx[slot].loops_left)
-	{
-		SSEnqueueChunk(chan, sound_fx[slot].buffer, sound_fx[slot].len, slot, pxtLooper);
-	}
-	else
-	{
-		pxtSoundDone(chan, slot);
-	}
-	
-	if (sound_fx[slot].loops_left > 0) sound_fx[slot].loops_left--;
-}
-
 void pxt_Stop(int slot)
 {	/// possible threading issues here? i'm not sure if it's important enough
 	/// i don't want to lock the audio because i'm worried that when the sound is aborted
 	/// it could end up being left locked during the user's sound done callback.
 	if (sound_fx[slot].channel != -1)
 	{
-		sound_fx[slot].loops_left = 0;
 		SSAbortChannel(sound_fx[slot].channel);
 	}
 }
@@ -702,20 +684,31 @@ char pxt_IsPlaying(int slot)
 }
 
 
-// render all pxt files under "path" up to slot "top".
+// render all pxt files in the exe up to slot "top".
 // get them all ready to play in their sound slots.
-// if cache_name is specified the pcm audio data is cached under the given filename.
+// the rendered audio is restored from/saved to the boot cache when possible.
 char pxt_LoadSoundFX(int top)
 {
    int slot;
    stPXSound snd;
+   uint8_t *cache;
+   int cache_len;
 
    NX_LOG("Loading Sound FX...\n");
    load_top = top;
 
-   // get ready to do synthesis
+   // get ready to do synthesis. this is done even when restoring from the cache,
+   // as generating the white noise model also leaves the RNG in a known state.
    pxt_initsynth();
 
+   // try to load the cache if we can
+   cache = bootcache_find(BC_SOUNDFX, &cache_len);
+   if (cache && LoadFXCache(cache, cache_len, top) == 0)
+      return 0;
+
+   DBuffer cachebuf;
+   cachebuf.Append32(top);
+
 #ifdef _WIN32
    char slash = '\\';
 #else
@@ -743,25 +736,68 @@ char pxt_LoadSoundFX(int top)
       if (pxt_load(fp, &snd, slot)) continue;
       pxt_Render(&snd);
 
-      // dirty hack; lower the pitch of the Stream Sounds
-      // to match the way they actually sound in the game
-      // with the SSS0400 command.
-      if (slot == 40)
-         pxt_ChangePitch(&snd, 5.0f);
-      if (slot == 41)
-         pxt_ChangePitch(&snd, 6.0f);
-
       // upscale the sound to 16-bit for SDL_mixer then throw away the now unnecessary 8-bit data
       pxt_PrepareToPlay(&snd, slot);
       FreePXTBuf(&snd);
+
+      // save the ready-to-play audio to cache, so next time it can be used in-place
+      cachebuf.Append32(sound_fx[slot].len);
+      cachebuf.Append32(slot);
+      cachebuf.AppendData((uint8_t *)sound_fx[slot].buffer, sound_fx[slot].len * 2 * 2);
    }
 
    fclose(fp);
 
+   bootcache_add(BC_SOUNDFX, &cachebuf);
    return 0;
 }
 
 
+// restores all the PXT's out of the sound fx section of the boot cache.
+// the sounds are already in the format pxt_PrepareToPlay makes, so the slots
+// are simply pointed at them; the cache stays loaded for as long as they're used.
+// if succesful, returns 0.
+static char LoadFXCache(uint8_t *data, int length, int top)
+{
+uint8_t *end = data + length;
+uint32_t cache_top, len, slot;
+
+	if (length < 4)
+		return 1;
+	
+	memcpy(&cache_top, data, 4);
+	if (cache_top != (uint32_t)top)
+	{
+		NX_LOG("LoadFXCache: # of sounds has changed since cache creation\n");
+		return 1;
+	}
+	data += 4;
+	
+	NX_LOG("LoadFXCache: restoring pxts from cache\n");
+	while(data + 8 <= end)
+	{
+		memcpy(&len, data, 4);
+		memcpy(&slot, data + 4, 4);
+		data += 8;
+		
+		if (slot > 255 || len > (uint32_t)(end - data) / 4)
+		{
+			NX_ERR("LoadFXCache: sound cache is corrupt\n");
+			pxt_freeSoundFX();
+			return 1;
+		}
+		
+		sound_fx[slot].buffer = (int16_t *)data;
+		sound_fx[slot].len = len;
+		sound_fx[slot].shared = true;
+		
+		data += (len * 2 * 2);
+	}
+	
+	return 0;
+}
+
+
 void pxt_freeSoundFX(void)
 {
 int i;
@@ -769,8 +805,9 @@ int i;
 	{
 		if (sound_fx[i].buffer)
 		{
-			free(sound_fx[i].buffer);
+			if (!sound_fx[i].shared) free(sound_fx[i].buffer);
 			sound_fx[i].buffer = NULL;
+			sound_fx[i].shared = false;
 		}
 	}
 }
@@ -779,8 +816,9 @@ void pxt_FreeSound(int slot)
 {
 	if (sound_fx[slot].buffer)
 	{
-		free(sound_fx[slot].buffer);
+		if (!sound_fx[slot].shared) free(sound_fx[slot].buffer);
 		sound_fx[slot].buffer = NULL;
+		sound_fx[slot].shared = false;
 	}
 }
 
@@ -8,6 +8,7 @@
 #include "../nx.h"
 #include "../settings.h"
 #include "pxt.h"
+#include "sslib.h"
 #include "sound.h"
 #include "sound.fdh"
 
@@ -27,6 +28,11 @@ static int cursong = 0;
 #define NUM_SOUNDS		0x75
 #define ORG_VOLUME		75
 
+// the Stream Sounds are slowed right down. at SSS0400 they sound the way they do
+// in the game at a fifth and a sixth of their normal speed; other frequencies
+// are scaled from there.
+#define STREAM_BASE_FREQ	400
+
 const char *org_names[] =
 {
 	NULL,
@@ -136,12 +142,21 @@ bool sound_is_playing(int snd)
 
 void StartStreamSound(int freq)
 {
-	// pxt_ChangePitch(SND_STREAM1, some_formula);
-	// pxt_ChangePitch(SND_STREAM2, some_other_formula);
+	pxt_SetRate(SND_STREAM1, stream_rate(freq, 5));
+	pxt_SetRate(SND_STREAM2, stream_rate(freq, 6));
+	
 	sound_loop(SND_STREAM1);
 	sound_loop(SND_STREAM2);
 }
 
+static uint32_t stream_rate(int freq, int slowdown)
+{
+	if (freq <= 0)
+		freq = STREAM_BASE_FREQ;
+	
+	return (uint32_t)(((int64_t)SS_RATE_NORMAL * freq) / (STREAM_BASE_FREQ * slowdown));
+}
+
 void StartPropSound(void)
 {
 	sound_loop(SND_PROPELLOR);
@@ -232,8 +247,12 @@ static void start_track(int songno)
 	
    NX_LOG("start_track: %d\n\n", songno);
 	
+	int64_t start = Hitch::Now();
+	
 	if (!org_load(songno))
 		org_start(0);
+	
+	Hitch::Event(HE_MUSIC_START, start, org_names[songno]);
 }
 
 int music_cursong()		{ return cursong; }
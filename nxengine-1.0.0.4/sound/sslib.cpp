@@ -9,7 +9,9 @@
 #include "../common/basics.h"
 
 #include "../nx_logger.h"
+#include "SDL_simd.h"
 #include "sslib.h"
+#include "audiocheck.h"
 #include "sslib.fdh"
 
 #define SDL_MIX_MAXVOLUME 128
@@ -18,6 +20,7 @@ SSChannel channel[SS_NUM_CHANNELS];
 
 uint8_t *mixbuffer = NULL;
 int mix_pos;
+static bool mix_dry = false;		// only advancing the channels; see mixaudio
 
 int lockcount = 0;
 
@@ -28,36 +31,114 @@ static int AddBuffer(SSChannel *chan, int bytes)
 {
 	SSChunk *chunk = &chan->chunks[chan->head];
 	
+	if (chunk->rate != SS_RATE_NORMAL)
+		return AddResampled(chan, bytes);
+	
 	if (bytes > chunk->bytelength)
 		bytes = chunk->bytelength;
 	
 	// don't copy past end of chunk
 	if (chunk->bytepos+bytes > chunk->bytelength)
 	{
-		// add it to list of finished chunks
-		chan->FinishedChunkUserdata[chan->nFinishedChunks++] = chunk->userdata;
-		
-		// only add what's left. and advance the head pointer to the next chunk.
+		// only add what's left...
 		bytes = chunk->bytelength - chunk->bytepos;
-		if (++chan->head >= MAX_QUEUED_CHUNKS)
-         chan->head = 0;
+		if (!mix_dry)
+			memcpy(&mixbuffer[mix_pos], &chunk->bytebuffer[chunk->bytepos], bytes);
+		mix_pos += bytes;
+		
+		// ...then either go back round to the start of the loop,
+		// or advance the head pointer to the next chunk.
+		if (chunk->loops_left)
+		{
+			if (chunk->loops_left > 0) chunk->loops_left--;
+			chunk->bytepos = chunk->loopstart;
+		}
+		else
+		{
+			chunk->bytepos = chunk->bytelength;
+			FinishChunk(chan);
+		}
+		
+		return bytes;
 	}
 	
-	memcpy(&mixbuffer[mix_pos], &chunk->bytebuffer[chunk->bytepos], bytes);
+	if (!mix_dry)
+		memcpy(&mixbuffer[mix_pos], &chunk->bytebuffer[chunk->bytepos], bytes);
+	
 	mix_pos += bytes;
 	chunk->bytepos += bytes;
 	
 	return bytes;
 }
 
+// like AddBuffer, for chunks playing at some other rate. the samples are
+// stepped through at the chunk's rate, taking whichever one is under the read
+// position (the same as the pxt module used to do when re-rendering a sound
+// at a different pitch), so this is just as cheap as a straight copy.
+static int AddResampled(SSChannel *chan, int bytes)
+{
+SSChunk *chunk = &chan->chunks[chan->head];
+int16_t *out = mix_dry ? NULL : (int16_t *)&mixbuffer[mix_pos];
+int pos = (chunk->bytepos / 4);
+int loopstart = (chunk->loopstart / 4);
+int i, nsamples;
+
+	nsamples = (bytes / 4);
+	for(i=0;i<nsamples;i++)
+	{
+		// at a high rate, one step can go round a short loop more than once,
+		// and each time round counts as one of its loops
+		while(pos >= chunk->length && chunk->loops_left && loopstart < chunk->length)
+		{
+			if (chunk->loops_left > 0) chunk->loops_left--;
+			pos -= (chunk->length - loopstart);
+		}
+		
+		if (pos >= chunk->length)
+		{
+			FinishChunk(chan);
+			break;
+		}
+		
+		if (out)
+		{
+			*(out++) = chunk->buffer[pos * 2];
+			*(out++) = chunk->buffer[(pos * 2) + 1];
+		}
+		
+		chunk->frac += chunk->rate;
+		pos += (chunk->frac >> SS_RATE_SHIFT);
+		chunk->frac &= (SS_RATE_NORMAL - 1);
+	}
+	
+	chunk->bytepos = (pos * 4);
+	mix_pos += (i * 4);
+	
+	return (i * 4);
+}
+
+// add the chunk at head to the list of finished chunks, and move on to the next one.
+static void FinishChunk(SSChannel *chan)
+{
+	chan->FinishedChunkUserdata[chan->nFinishedChunks++] = chan->chunks[chan->head].userdata;
+	
+	if (++chan->head >= MAX_QUEUED_CHUNKS)
+		chan->head = 0;
+}
+
+// mixes len_samples of all channels into stream. if stream is NULL, the channels
+// are only advanced by that much, as if they'd been mixed, so that sounds still
+// finish (and the game still sees them as playing) exactly when they would have.
 void mixaudio(int16_t *stream, size_t len_samples)
 {
 	int bytes_copied;
 	int bytestogo;
 	int c;
 	int i;
+	const SDL_SIMDKernels *mix_kernels = SDL_GetSIMDKernels();
 
 	size_t len = len_samples * sizeof(int16_t);
+	mix_dry = (stream == NULL);
 
 	// get data for all channels and add it to the mix
 	for(c=0;c<SS_NUM_CHANNELS;c++)
@@ -73,28 +154,45 @@ void mixaudio(int16_t *stream, size_t len_samples)
 			
 			if (channel[c].head==channel[c].tail)
 			{
-				if (bytestogo)
+				if (bytestogo && !mix_dry)
 					memset(&mixbuffer[mix_pos], 0, bytestogo);
 				
 				break;
 			}
 		}
 	
+	if (mix_dry)
+		continue;
+	
 	// tell any callbacks that had a chunk finish, that their chunk finished
 	const int16_t *mixbuf = (const int16_t*)mixbuffer;
-
-	for(unsigned i = 0; i < len_samples; i++)
+	
+	if (audiocheck_active())
+		audiocheck_channel(c, mixbuf, len_samples, channel[c].volume);
+	
+	// the mix kernel covers the volumes that can only make a sound quieter
+	if (channel[c].volume >= 0 && channel[c].volume <= 2 * SDL_MIX_MAXVOLUME)
 	{
-		int32_t current = stream[i];
-		current += (int32_t)mixbuf[i] * channel[c].volume / (2 * SDL_MIX_MAXVOLUME);
-		if (current > 0x7fff)
-			stream[i] = 0x7fff;
-		else if (current < -0x8000)
-			stream[i] = -0x8000;
-		else
-			stream[i] = current;
+		mix_kernels->Mix16(stream, mixbuf, len_samples, channel[c].volume);
 	}
+	else
+	{
+		for(unsigned i = 0; i < len_samples; i++)
+		{
+			int32_t current = stream[i];
+			current += (int32_t)mixbuf[i] * channel[c].volume / (2 * SDL_MIX_MAXVOLUME);
+			if (current > 0x7fff)
+				stream[i] = 0x7fff;
+			else if (current < -0x8000)
+				stream[i] = -0x8000;
+			else
+				stream[i] = current;
+		}
 	}
+	}
+	
+	if (audiocheck_active() && !mix_dry)
+		audiocheck_block(stream, len_samples);
 
 	for(c=0;c<SS_NUM_CHANNELS;c++)
 	{
@@ -163,6 +261,19 @@ int i;
 //
 // returns:		the channel sound was started on, or -1 if failure.
 int SSEnqueueChunk(int c, signed short *buffer, int len, int userdata, void(*FinishedCB)(int, int))
+{
+	return SSEnqueueVoice(c, buffer, len, 0, 0, SS_RATE_NORMAL, userdata, FinishedCB);
+}
+
+// enqueues a chunk the way SSEnqueueChunk does, but with a loop and playback rate.
+// loopstart:	where to go back to on reaching the end, in stereo samples like len
+// loops:		how many times to go back there before finishing, or SS_LOOP_FOREVER
+// rate:		the speed to play it at; SS_RATE_NORMAL plays it as it is
+//
+// a looping chunk costs nothing extra to go back round, and playing one at a
+// different rate doesn't need a re-rendered copy of the buffer.
+int SSEnqueueVoice(int c, signed short *buffer, int len, int loopstart, int loops, \
+					uint32_t rate, int userdata, void(*FinishedCB)(int, int))
 {
 SSChannel *chan;
 SSChunk *chunk;
@@ -196,6 +307,14 @@ SSChunk *chunk;
 	chunk->bytelength = chunk->length * 2 * 2;		// in bytes
 	
 	chunk->bytepos = 0;
+	chunk->frac = 0;
+	chunk->rate = rate ? rate : SS_RATE_NORMAL;
+	
+	if (loopstart < 0 || loopstart >= len)
+		loopstart = 0;
+	
+	chunk->loopstart = (loopstart * 2 * 2);
+	chunk->loops_left = (len > 0) ? loops : 0;
 	
 	// advance tail pointer
 	if (++chan->tail >= MAX_QUEUED_CHUNKS) chan->tail = 0;
@@ -222,6 +341,15 @@ int SSPlayChunk(int c, signed short *buffer, int len, int userdata, void(*Finish
 	return SSEnqueueChunk(c, buffer, len, userdata, FinishedCB);
 }
 
+// plays a chunk with a loop and playback rate; see SSEnqueueVoice.
+int SSPlayVoice(int c, signed short *buffer, int len, int loopstart, int loops, \
+				uint32_t rate, int userdata, void(*FinishedCB)(int, int))
+{
+	if (c != -1) SSAbortChannel(c);
+	
+	return SSEnqueueVoice(c, buffer, len, loopstart, loops, rate, userdata, FinishedCB);
+}
+
 // returns true if channel c is currently playing
 char SSChannelPlaying(int c)
 {
@@ -316,6 +444,21 @@ void SSSetVolume(int c, int newvol)
 	SSUnlockAudio();
 }
 
+// changes the playback rate of all chunks playing or queued on a channel.
+// it takes effect from the next sample, without restarting anything.
+void SSSetRate(int c, uint32_t rate)
+{
+	SSLockAudio();
+	
+	for(int i=channel[c].head;i!=channel[c].tail;)
+	{
+		channel[c].chunks[i].rate = rate ? rate : SS_RATE_NORMAL;
+		if (++i >= MAX_QUEUED_CHUNKS) i = 0;
+	}
+	
+	SSUnlockAudio();
+}
+
 /*
 void c------------------------------() {}
 */
@@ -6,6 +6,13 @@
 #define MAX_QUEUED_CHUNKS		(180 +1)
 #define SS_NUM_CHANNELS			16
 
+// chunks can be played at other than their normal speed, which also changes their
+// pitch. the rate is in 16.16 fixed-point samples of the chunk per sample of output.
+#define SS_RATE_SHIFT			16
+#define SS_RATE_NORMAL			(1 << SS_RATE_SHIFT)
+
+#define SS_LOOP_FOREVER			-1
+
 struct SSChunk
 {
 	signed short *buffer;
@@ -16,6 +23,13 @@ struct SSChunk
 	
 	// current read position. this is within bytebuffer and is in BYTES.
 	int bytepos;
+	uint32_t frac;						// fractional part of it, when not playing at SS_RATE_NORMAL
+	uint32_t rate;
+	
+	// on reaching the end, playback goes back round to loopstart (also in BYTES)
+	// this many more times; SS_LOOP_FOREVER loops until the channel is aborted.
+	int loopstart;
+	int loops_left;
 	
 	int userdata;						// user data to be sent to FinishedCallback when finished
 };
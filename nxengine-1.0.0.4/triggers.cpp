@@ -0,0 +1,186 @@
+
+// the trigger index; see triggers.h.
+
+#include "nx.h"
+#include "triggers.fdh"
+
+static struct
+{
+	bool valid;
+	uint32_t gen;			// bumped by each rebuild; indexed triggers have it in hvt.index_gen
+	uint32_t stamp;			// bumped by each lookup; triggers the player is in get it in hvt.hit_stamp
+	
+	int cols, rows;
+	int *cellstart;			// where each cell's triggers start in entries; one more than there are cells
+	Object **entries;		// the triggers overlapping each cell, in creation order
+	int maxcells, maxentries;
+	
+	bool looked_up;
+	int px, py;				// where the player's center was for the last lookup
+} tr;
+
+
+// has the index rebuilt the next time it's used
+void Triggers::Invalidate(void)
+{
+	tr.valid = false;
+}
+
+// returns true if the player's center is within the box of the given trigger,
+// and so it should run. one which isn't in the index yet always runs.
+bool Triggers::IsTouching(Object *o)
+{
+	// that draws the boxes of all of them, so they'd all better run
+	if (game.debug.DrawBoundingBoxes)
+		return true;
+	
+	if (!tr.valid)
+		rebuild();
+	
+	if (o->hvt.index_gen != tr.gen)
+	{
+		tr.valid = false;
+		return true;
+	}
+	
+	// the player is usually only moved once per tick, but a few AIs also push
+	// him around, so this makes sure each trigger sees wherever he is right then.
+	int px = player->CenterX();
+	int py = player->CenterY();
+	
+	if (!tr.looked_up || px != tr.px || py != tr.py)
+		lookup(px, py);
+	
+	return (o->hvt.hit_stamp == tr.stamp);
+}
+
+void Triggers::Close(void)
+{
+	free(tr.cellstart);
+	free(tr.entries);
+	memset(&tr, 0, sizeof(tr));
+}
+
+/*
+void c------------------------------() {}
+*/
+
+// marks all the triggers the player's center is inside
+static void lookup(int px, int py)
+{
+	if (++tr.stamp == 0)
+		tr.stamp = 1;
+	
+	tr.looked_up = true;
+	tr.px = px;
+	tr.py = py;
+	
+	int cell = (get_cell(py, TILE_H, tr.rows) * tr.cols) + get_cell(px, TILE_W, tr.cols);
+	
+	for(int i=tr.cellstart[cell];i<tr.cellstart[cell+1];i++)
+	{
+		Object *o = tr.entries[i];
+		
+		// the same test as ai_hvtrigger
+		if (px > o->hvt.x2 || px < o->hvt.x1) continue;
+		if (py > o->hvt.y2 || py < o->hvt.y1) continue;
+		
+		o->hvt.hit_stamp = tr.stamp;
+	}
+}
+
+static void rebuild(void)
+{
+Object *o;
+int x1, y1, x2, y2;
+int x, y, c;
+
+	if (++tr.gen == 0)
+		tr.gen = 1;
+	
+	tr.cols = MAX(1, (map.xsize + TRIGGER_CELL_TILES - 1) / TRIGGER_CELL_TILES);
+	tr.rows = MAX(1, (map.ysize + TRIGGER_CELL_TILES - 1) / TRIGGER_CELL_TILES);
+	int ncells = (tr.cols * tr.rows);
+	
+	if (ncells + 1 > tr.maxcells)
+	{
+		tr.maxcells = (ncells + 1);
+		tr.cellstart = (int *)realloc(tr.cellstart, tr.maxcells * sizeof(int));
+	}
+	
+	memset(tr.cellstart, 0, (ncells + 1) * sizeof(int));
+	
+	// count how many triggers overlap each cell, shifted up one...
+	FOREACH_OBJECT(o)
+	{
+		if (o->type != OBJ_HVTRIGGER)
+			continue;
+		
+		if (!IsStaticTrigger(o) || o->deleted)
+		{
+			o->hvt.index_gen = 0;
+			continue;
+		}
+		
+		get_cells(o, &x1, &y1, &x2, &y2);
+		for(y=y1;y<=y2;y++)
+		for(x=x1;x<=x2;x++)
+			tr.cellstart[(y * tr.cols) + x + 1]++;
+	}
+	
+	// ...which turns into where each cell starts
+	for(c=0;c<ncells;c++)
+		tr.cellstart[c + 1] += tr.cellstart[c];
+	
+	int nentries = tr.cellstart[ncells];
+	if (nentries > tr.maxentries)
+	{
+		tr.maxentries = nentries;
+		tr.entries = (Object **)realloc(tr.entries, tr.maxentries * sizeof(Object *));
+	}
+	
+	// fill the cells, using the starts as a cursor; afterwards they
+	// each point at where the next cell starts, so move them back down.
+	FOREACH_OBJECT(o)
+	{
+		if (o->type != OBJ_HVTRIGGER || !IsStaticTrigger(o) || o->deleted)
+			continue;
+		
+		get_cells(o, &x1, &y1, &x2, &y2);
+		for(y=y1;y<=y2;y++)
+		for(x=x1;x<=x2;x++)
+			tr.entries[tr.cellstart[(y * tr.cols) + x]++] = o;
+		
+		o->hvt.index_gen = tr.gen;
+		o->hvt.hit_stamp = 0;
+	}
+	
+	for(c=ncells;c>0;c--)
+		tr.cellstart[c] = tr.cellstart[c - 1];
+	tr.cellstart[0] = 0;
+	
+	tr.valid = true;
+	tr.looked_up = false;
+	
+	NX_LOG("Triggers: indexed %d cell entries over a %dx%d grid\n", nentries, tr.cols, tr.rows);
+}
+
+// returns the range of cells a trigger's box covers. the player's
+// position is clamped to the grid the same way when looking it up,
+// so a box which hangs off the map is still found.
+static void get_cells(Object *o, int *x1, int *y1, int *x2, int *y2)
+{
+	*x1 = get_cell(o->hvt.x1, TILE_W, tr.cols);
+	*y1 = get_cell(o->hvt.y1, TILE_H, tr.rows);
+	*x2 = get_cell(o->hvt.x2, TILE_W, tr.cols);
+	*y2 = get_cell(o->hvt.y2, TILE_H, tr.rows);
+}
+
+static int get_cell(int coord, int tilesize, int ncells)
+{
+	int cell = ((coord >> CSF) / tilesize) / TRIGGER_CELL_TILES;
+	
+	if (cell < 0) return 0;
+	if (cell >= ncells) return (ncells - 1);
+	return cell;
+}
@@ -0,0 +1,36 @@
+
+#ifndef _TRIGGERS_H
+#define _TRIGGERS_H
+
+// the trigger index. an OBJ_HVTRIGGER never moves, and all it does is start a
+// script once the player's center is inside a box, which it works out the first
+// time it runs. rather than every one of them checking the player on every tick,
+// those which have been set up are put into a coarse grid over the map, which is
+// looked up once per tick with the player's position; only the triggers he's
+// actually inside get their AI run, and none of them need the block state and
+// physics updates every other object gets.
+//
+// the grid is rebuilt when a trigger is set up, changes type or is destroyed,
+// which in practice means once as each stage starts.
+
+#define TRIGGER_CELL_TILES		8		// width and height of each cell of the grid
+
+namespace Triggers
+{
+	void Invalidate(void);
+	bool IsTouching(Object *o);
+	
+	void Close(void);
+};
+
+// true for hvtriggers which have been set up, and so belong in the index.
+// one that's somehow been given inertia or a touch script is left to the
+// normal updates, as it's then doing more than just watching its box.
+static inline bool IsStaticTrigger(Object *o)
+{
+	return (o->type == OBJ_HVTRIGGER && o->state != 0 && \
+			o->xinertia == 0 && o->yinertia == 0 && \
+			!(o->flags & FLAG_SCRIPTONTOUCH));
+}
+
+#endif
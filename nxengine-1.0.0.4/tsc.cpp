@@ -172,25 +172,20 @@ bool tsc_load(const char *fname, int pageno)
 
 char *tsc_decrypt(const char *fname, int *fsize_out)
 {
-FILE *fp;
+DBuffer file;
 int fsize, i;
 
-	fp = fopen(fname, "rb");
-	if (!fp)
+	if (bundle_read_file(fname, &file))
 	{
 		NX_ERR("tsc_decrypt: no such file: '%s'!\n", fname);
 		return NULL;
 	}
 	
-	fseek(fp, 0, SEEK_END);
-	fsize = ftell(fp);
-	fseek(fp, 0, SEEK_SET);
-	
 	// load file
+	fsize = file.Length();
 	char *buf = (char *)malloc(fsize+1);
-	fread(buf, fsize, 1, fp);
+	memcpy(buf, file.Data(), fsize);
 	buf[fsize] = 0;
-	fclose(fp);
 	
 	// get decryption key, which is actually part of the text
 	int keypos = (fsize / 2);
@@ -381,6 +376,25 @@ ScriptInstance *GetCurrentScriptInstance()
 	return NULL;
 }
 
+// returns the total size of the compiled scripts in all pages
+int tsc_script_bytes(void)
+{
+	int total = 0;
+	
+	for(int p=0;p<NUM_SCRIPT_PAGES;p++)
+	{
+		ScriptPage *page = &script_pages[p];
+		
+		for(int i=0;i<page->scripts.nitems;i++)
+		{
+			DBuffer *script = page->scripts.get(i);
+			if (script) total += script->Length();
+		}
+	}
+	
+	return total;
+}
+
 /*
 void c------------------------------() {}
 */
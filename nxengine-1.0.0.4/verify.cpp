@@ -0,0 +1,317 @@
+
+// replay verification; see verify.h.
+
+#include "nx.h"
+#include "verify.h"
+#include "common/checksum.h"
+#include "verify.fdh"
+
+static const char *part_names[] = { "random", "player", "objects", "world" };
+
+static struct
+{
+	int mode;
+	int interval;
+	
+	bool active;
+	bool recording;
+	FILE *fp;
+	char fname[MAXPATHLEN];
+	
+	int ncheckpoints;
+	int last_frame;			// of the last checkpoint passed
+	bool ref_ended;
+	bool failed;
+} vf;
+
+
+void Verify::SetMode(int mode, int interval)
+{
+	vf.mode = mode;
+	vf.interval = (interval > 0) ? MIN(interval, VERIFY_MAX_INTERVAL) : VERIFY_DEFAULT_INTERVAL;
+}
+
+int Verify::GetMode(void)
+{
+	return vf.mode;
+}
+
+/*
+void c------------------------------() {}
+*/
+
+// called as a replay is about to begin playback. opens or creates
+// the checkpoints belonging to that replay.
+bool Verify::Begin(const char *replay_fname)
+{
+	End();
+	if (vf.mode == VERIFY_OFF)
+		return 0;
+	
+	if (vf.interval <= 0)
+		vf.interval = VERIFY_DEFAULT_INTERVAL;
+	
+	get_checkpoint_name(replay_fname, vf.fname);
+	vf.recording = true;
+	vf.fp = NULL;
+	
+	if (vf.mode == VERIFY_AUTO)
+	{
+		FILE *fp = fopen(vf.fname, "rb");
+		if (fp)
+		{
+			// the interval is whatever the checkpoints were recorded with
+			uint32_t magick = fgetl(fp);
+			uint32_t version = fgetl(fp);
+			uint32_t interval = fgetl(fp);
+			
+			if (magick == VERIFY_MAGICK && version == VERIFY_VERSION && \
+				interval > 0 && interval <= VERIFY_MAX_INTERVAL && !feof(fp))
+			{
+				vf.interval = interval;
+				vf.fp = fp;
+				vf.recording = false;
+			}
+			else
+			{
+				NX_ERR("Verify: '%s' is not a valid checkpoint file; re-recording it\n", vf.fname);
+				fclose(fp);
+			}
+		}
+	}
+	
+	if (vf.recording)
+	{
+		vf.fp = fopen(vf.fname, "wb");
+		if (!vf.fp)
+		{
+			NX_ERR("Verify: couldn't create '%s'\n", vf.fname);
+			return 1;
+		}
+		
+		fputl(VERIFY_MAGICK, vf.fp);
+		fputl(VERIFY_VERSION, vf.fp);
+		fputl(vf.interval, vf.fp);
+	}
+	
+	vf.ncheckpoints = 0;
+	vf.last_frame = 0;
+	vf.ref_ended = false;
+	vf.failed = false;
+	vf.active = true;
+	
+	NX_LOG("Verify: %s '%s', every %d frames\n", \
+			vf.recording ? "recording" : "verifying against", vf.fname, vf.interval);
+	return 0;
+}
+
+// called when playback ends; closes the checkpoints and reports the result.
+void Verify::End(void)
+{
+	if (!vf.active)
+		return;
+	
+	vf.active = false;
+	
+	if (vf.recording)
+	{
+		NX_LOG("Verify: recorded %d checkpoints to '%s'\n", vf.ncheckpoints, vf.fname);
+		visible_warning("verify: recorded %d checkpoints", vf.ncheckpoints);
+	}
+	else if (!vf.failed)
+	{
+		VerifyCheckpoint ref;
+		if (!vf.ref_ended && read_checkpoint(&ref))
+		{
+			NX_ERR("Verify: playback ended after frame %d, but the reference goes on to frame %d\n", \
+					vf.last_frame, ref.frame);
+			visible_warning("verify: FAILED; ended early");
+		}
+		else
+		{
+			NX_LOG("Verify: all %d checkpoints match\n", vf.ncheckpoints);
+			visible_warning("verify: %d checkpoints OK", vf.ncheckpoints);
+		}
+	}
+	
+	fclose(vf.fp);
+	vf.fp = NULL;
+}
+
+// called by replay playback at the start of every frame, before the game runs it.
+// returns 1 if the segment which just ended has diverged, and playback should stop.
+bool Verify::OnFrame(int frameno)
+{
+VerifyCheckpoint cp, ref;
+
+	if (!vf.active || (frameno % vf.interval) != 0)
+		return 0;
+	
+	TakeCheckpoint(&cp);
+	cp.frame = frameno;
+	vf.ncheckpoints++;
+	
+	if (vf.recording)
+	{
+		write_checkpoint(&cp);
+		vf.last_frame = frameno;
+		return 0;
+	}
+	
+	if (vf.ref_ended)
+		return 0;
+	
+	if (!read_checkpoint(&ref))
+	{
+		// playback going on past the end of the reference isn't itself wrong;
+		// the reference might have been recorded with a stop frame.
+		NX_LOG("Verify: the reference ends at frame %d\n", vf.last_frame);
+		vf.ref_ended = true;
+		return 0;
+	}
+	
+	if (ref.frame != cp.frame)
+	{
+		NX_ERR("Verify: checkpoint %d is at frame %d, but frame %d in the reference\n", \
+				vf.ncheckpoints, cp.frame, ref.frame);
+		return failed(frameno, "timing");
+	}
+	
+	const char *first_part = NULL;
+	for(int i=0;i<VP_NUM_PARTS;i++)
+	{
+		if (cp.part[i] != ref.part[i])
+		{
+			NX_ERR("Verify: the %s state differs at frame %d\n", part_names[i], frameno);
+			if (!first_part) first_part = part_names[i];
+		}
+	}
+	
+	if (first_part)
+		return failed(frameno, first_part);
+	
+	vf.last_frame = frameno;
+	return 0;
+}
+
+static bool failed(int frameno, const char *what)
+{
+	NX_ERR("Verify: FAILED; the segment from frame %d to %d diverged\n", vf.last_frame, frameno);
+	visible_warning("verify: FAILED in frames %d-%d (%s)", vf.last_frame, frameno, what);
+	
+	vf.failed = true;
+	return 1;
+}
+
+/*
+void c------------------------------() {}
+*/
+
+// digests the parts of the game state which the simulation depends on
+void Verify::TakeCheckpoint(VerifyCheckpoint *cp)
+{
+uint32_t hash;
+Object *o;
+int i;
+
+	memset(cp, 0, sizeof(VerifyCheckpoint));
+	
+	uint32_t seed = getrandseed();
+	cp->part[VP_RANDOM] = fnv_hash(FNV_BASIS, &seed, sizeof(seed));
+	
+	hash = digest_object(FNV_BASIS, player);
+	hash = fnv_hash(hash, &player->maxHealth, sizeof(player->maxHealth));
+	hash = fnv_hash(hash, &player->curWeapon, sizeof(player->curWeapon));
+	hash = fnv_hash(hash, &player->equipmask, sizeof(player->equipmask));
+	hash = fnv_hash(hash, &player->ninventory, sizeof(player->ninventory));
+	hash = fnv_hash(hash, player->inventory, player->ninventory * sizeof(int));
+	
+	for(i=0;i<WPN_COUNT;i++)
+	{
+		Weapon *wpn = &player->weapons[i];
+		
+		hash = fnv_hash(hash, &wpn->hasWeapon, sizeof(wpn->hasWeapon));
+		hash = fnv_hash(hash, &wpn->xp, sizeof(wpn->xp));
+		hash = fnv_hash(hash, &wpn->level, sizeof(wpn->level));
+		hash = fnv_hash(hash, &wpn->ammo, sizeof(wpn->ammo));
+		hash = fnv_hash(hash, &wpn->maxammo, sizeof(wpn->maxammo));
+	}
+	
+	cp->part[VP_PLAYER] = hash;
+	
+	hash = FNV_BASIS;
+	FOREACH_OBJECT(o)
+	{
+		if (o != player)
+			hash = digest_object(hash, o);
+	}
+	
+	cp->part[VP_OBJECTS] = hash;
+	
+	hash = fnv_hash(FNV_BASIS, &game.curmap, sizeof(game.curmap));
+	hash = fnv_hash(hash, &game.mode, sizeof(game.mode));
+	hash = fnv_hash(hash, game.flags, sizeof(game.flags));
+	hash = fnv_hash(hash, game.skipflags, sizeof(game.skipflags));
+	
+	for(i=0;i<map.ysize;i++)
+	for(int x=0;x<map.xsize;x++)
+		hash = fnv_hash(hash, &map.tiles[x][i], 1);
+	
+	cp->part[VP_WORLD] = hash;
+}
+
+static uint32_t digest_object(uint32_t hash, Object *o)
+{
+	hash = fnv_hash(hash, &o->type, sizeof(o->type));
+	hash = fnv_hash(hash, &o->x, sizeof(o->x));
+	hash = fnv_hash(hash, &o->y, sizeof(o->y));
+	hash = fnv_hash(hash, &o->xinertia, sizeof(o->xinertia));
+	hash = fnv_hash(hash, &o->yinertia, sizeof(o->yinertia));
+	hash = fnv_hash(hash, &o->dir, sizeof(o->dir));
+	hash = fnv_hash(hash, &o->hp, sizeof(o->hp));
+	hash = fnv_hash(hash, &o->state, sizeof(o->state));
+	hash = fnv_hash(hash, &o->frame, sizeof(o->frame));
+	hash = fnv_hash(hash, &o->timer, sizeof(o->timer));
+	return hash;
+}
+
+/*
+void c------------------------------() {}
+*/
+
+// the checkpoints are written out field by field, so they're portable between systems
+static void write_checkpoint(VerifyCheckpoint *cp)
+{
+	fputl(cp->frame, vf.fp);
+	
+	for(int i=0;i<VP_NUM_PARTS;i++)
+		fputl(cp->part[i], vf.fp);
+}
+
+static bool read_checkpoint(VerifyCheckpoint *cp)
+{
+	uint32_t buffer[1 + VP_NUM_PARTS];
+	if (fread(buffer, sizeof(buffer), 1, vf.fp) != 1)
+		return 0;
+	
+	const uint8_t *ptr = (const uint8_t *)buffer;
+	const uint8_t *end = ptr + sizeof(buffer);
+	
+	cp->frame = read_U32(&ptr, end);
+	for(int i=0;i<VP_NUM_PARTS;i++)
+		cp->part[i] = read_U32(&ptr, end);
+	
+	return 1;
+}
+
+// the checkpoints for "replay/rep0.dat" are in "replay/rep0.chk"
+static void get_checkpoint_name(const char *replay_fname, char *buffer)
+{
+	maxcpy(buffer, replay_fname, MAXPATHLEN - 8);
+	
+	char *ext = strrchr(buffer, '.');
+	if (ext && !strchr(ext, '/') && !strchr(ext, '\\'))
+		*ext = 0;
+	
+	strcat(buffer, VERIFY_EXTENSION);
+}
@@ -0,0 +1,56 @@
+
+#ifndef _VERIFY_H
+#define _VERIFY_H
+
+// replay verification. while a replay plays back, a checkpoint is taken every so
+// many frames: a digest of the game state, split into a few parts. a reference
+// playback writes them into a .chk next to the replay, and later playbacks are
+// compared against it, so that a change which throws the simulation off is caught
+// within a few seconds of where it happened, along with which part of the state
+// went wrong first. verification stops at the first segment (the frames between
+// two checkpoints) which doesn't match, rather than playing out the whole replay.
+
+#define VERIFY_MAGICK			'NXVC'
+#define VERIFY_VERSION			1
+#define VERIFY_EXTENSION		".chk"
+
+#define VERIFY_DEFAULT_INTERVAL	300			// frames between checkpoints
+#define VERIFY_MAX_INTERVAL		(60 * 60 * 60)	// an hour
+
+enum VerifyModes
+{
+	VERIFY_OFF,
+	VERIFY_AUTO,			// verify against the checkpoints if there are any, else record them
+	VERIFY_RECORD			// always (re-)record the checkpoints
+};
+
+// the parts of the game state which are digested separately
+enum VerifyParts
+{
+	VP_RANDOM,				// the random number generator
+	VP_PLAYER,				// position, health, weapons and inventory
+	VP_OBJECTS,				// every object's type, position, AI state etc
+	VP_WORLD,				// the stage, game mode, script flags and map tiles
+	
+	VP_NUM_PARTS
+};
+
+struct VerifyCheckpoint
+{
+	int32_t frame;
+	uint32_t part[VP_NUM_PARTS];
+};
+
+namespace Verify
+{
+	void SetMode(int mode, int interval);
+	int GetMode(void);
+	
+	bool Begin(const char *replay_fname);
+	void End(void);
+	bool OnFrame(int frameno);
+	
+	void TakeCheckpoint(VerifyCheckpoint *cp);
+};
+
+#endif